@@ -9,6 +9,33 @@
 #include <numeric>
 #include <algorithm>
 #include <array>
+#include <cstdint>
+
+// Converts the morse notation of the assignment ("/" between symbols) to ADFGVX letters.
+// Unknown morse symbols and all other characters (spaces, newlines, ...) are ignored.
+inline std::string morseToADFGVX(const std::string& morse_code) {
+    static const std::map<std::string, char> morse_map = {
+        {".-",   'A'}, {"-..",  'D'}, {"..-.", 'F'},
+        {"--.",  'G'}, {"...-", 'V'}, {"-..-", 'X'}
+    };
+    std::string adfgvx_text;
+    std::string current_morse_char;
+    auto flush = [&]() {
+        auto it = morse_map.find(current_morse_char);
+        if (it != morse_map.end()) adfgvx_text += it->second;
+        current_morse_char.clear();
+    };
+    for (char c : morse_code) {
+        if (c == '.' || c == '-') {
+            current_morse_char += c;
+        } else if (c == '/') {
+            flush();
+        }
+    }
+    // The last symbol, if the text does not end with '/'.
+    flush();
+    return adfgvx_text;
+}
 
 class ADFGVX {
 public:
@@ -48,6 +75,7 @@ public:
         // Build the 6x6 grid and the coordinate map for fast lookups
         const std::string adfgvx_chars = "ADFGVX";
         coords_to_char.clear();
+        char_to_coords.clear();
         for (int i = 0; i < 36; ++i) {
             int row = i / 6;
             int col = i % 6;
@@ -58,6 +86,7 @@ public:
             coords_str += adfgvx_chars[row];
             coords_str += adfgvx_chars[col];
             coords_to_char[coords_str] = square_key[i];
+            char_to_coords[square_key[i]] = coords_str;
         }
     }
 
@@ -68,20 +97,44 @@ public:
         }
 
         // First, undo the columnar transposition
-        std::string intermediate_text = undoColumnarTransposition(ciphertext);
+        std::string intermediate_text = undoColumnarTransposition(ciphertext, transposition_order);
         if (intermediate_text.empty()) return "";
 
         // Second, undo the substitution from the Polybius square
         return performSubstitution(intermediate_text);
     }
 
-private:
-    std::vector<int> transposition_order;
-    char grid[6][6]{};
-    std::map<std::string, char> coords_to_char;
+    // Encrypts plaintext made of characters from the square (the inverse of decrypt).
+    // Characters that are not in the square are skipped.
+    std::string encrypt(const std::string& plaintext) const {
+        if (transposition_order.empty()) {
+            throw std::runtime_error("Keys are not set.");
+        }
+        std::string intermediate_text;
+        intermediate_text.reserve(plaintext.length() * 2);
+        for (char c : plaintext) {
+            auto it = char_to_coords.find(c);
+            if (it != char_to_coords.end()) intermediate_text += it->second;
+        }
+        return applyColumnarTransposition(intermediate_text, transposition_order);
+    }
 
-    // Reverses the columnar transposition stage.
-std::string undoColumnarTransposition(const std::string& ciphertext) const {
+    // Columnar transposition: write the text row by row under num_cols columns and read the
+    // columns in the given order. undoColumnarTransposition reverses this.
+    static std::string applyColumnarTransposition(const std::string& text, const std::vector<int>& transposition_order) {
+        int num_cols = transposition_order.size();
+        std::string ciphertext;
+        ciphertext.reserve(text.length());
+        for (int col : transposition_order) {
+            for (size_t pos = col; pos < text.length(); pos += num_cols) ciphertext += text[pos];
+        }
+        return ciphertext;
+    }
+
+    // Reverses the columnar transposition stage for an arbitrary column order.
+    // Public and static so that callers (e.g. the crib filter) can inspect the
+    // digraph stream of a transposition without setting a Polybius square.
+static std::string undoColumnarTransposition(const std::string& ciphertext, const std::vector<int>& transposition_order) {
     int num_cols = transposition_order.size();
     if (num_cols == 0) return "";
 
@@ -124,6 +177,30 @@ std::string undoColumnarTransposition(const std::string& ciphertext) const {
     return intermediate_text;
 }
 
+    // The digraph stream after undoing the transposition, as Polybius cells (row * 6 + col).
+    // For the square search, where the transposition stays fixed and only the square changes:
+    // plaintext[k] = square_key[cells[k]]. Empty if the stream is not a whole number of valid digraphs.
+    static std::vector<uint8_t> digraphCells(const std::string& ciphertext, const std::vector<int>& transposition_order) {
+        std::string intermediate_text = undoColumnarTransposition(ciphertext, transposition_order);
+        if (intermediate_text.empty() || intermediate_text.length() % 2 != 0) return {};
+        const std::string adfgvx_chars = "ADFGVX";
+        std::vector<uint8_t> cells;
+        cells.reserve(intermediate_text.length() / 2);
+        for (size_t i = 0; i < intermediate_text.length(); i += 2) {
+            size_t row = adfgvx_chars.find(intermediate_text[i]);
+            size_t col = adfgvx_chars.find(intermediate_text[i + 1]);
+            if (row == std::string::npos || col == std::string::npos) return {};
+            cells.push_back(static_cast<uint8_t>(row * 6 + col));
+        }
+        return cells;
+    }
+
+private:
+    std::vector<int> transposition_order;
+    char grid[6][6]{};
+    std::map<std::string, char> coords_to_char;
+    std::map<char, std::string> char_to_coords;
+
     // Reverses the substitution stage (converts digraphs back to single characters).
     std::string performSubstitution(const std::string& intermediate_text) const {
         if (intermediate_text.length() % 2 != 0) {
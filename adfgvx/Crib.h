@@ -0,0 +1,183 @@
+#ifndef ADFGVX_CRIB_H
+#define ADFGVX_CRIB_H
+
+#include <string>
+#include <vector>
+#include <array>
+#include <stdexcept>
+#include <algorithm>
+#include <cctype>
+
+#include "../common/Random.h"
+
+// A known or probable plaintext fragment.
+// min_pos/max_pos restrict the start position (letter index in the plaintext);
+// max_pos == -1 means "anywhere". With several messages (depth) positions count through the
+// messages joined end to end, but a crib must lie within a single message.
+struct Crib {
+    std::string text;
+    int min_pos = 0;
+    int max_pos = -1;
+};
+
+// Parses a crib specification: "TEXT", "TEXT@12" (exact start) or "TEXT@10-40" (range).
+inline Crib parseCrib(const std::string& spec) {
+    Crib crib;
+    std::string text_part = spec;
+    size_t at = spec.find('@');
+    if (at != std::string::npos) {
+        text_part = spec.substr(0, at);
+        std::string range = spec.substr(at + 1);
+        size_t dash = range.find('-');
+        try {
+            if (dash == std::string::npos) {
+                crib.min_pos = crib.max_pos = std::stoi(range);
+            } else {
+                crib.min_pos = std::stoi(range.substr(0, dash));
+                crib.max_pos = std::stoi(range.substr(dash + 1));
+            }
+        } catch (const std::exception&) {
+            throw std::invalid_argument("Ongeldige crib-positie: " + spec);
+        }
+        if (crib.min_pos < 0 || (crib.max_pos >= 0 && crib.max_pos < crib.min_pos)) {
+            throw std::invalid_argument("Ongeldige crib-positie: " + spec);
+        }
+    }
+
+    for (char c : text_part) {
+        if (std::isalnum(static_cast<unsigned char>(c))) {
+            crib.text += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+    }
+    if (crib.text.empty()) {
+        throw std::invalid_argument("Lege crib: " + spec);
+    }
+    return crib;
+}
+
+// Square cells implied by the cribs. cell_to_char[cell] == 0 means the cell is free.
+struct CribPins {
+    std::array<char, 36> cell_to_char{};
+    std::array<signed char, 256> char_to_cell;
+
+    CribPins() { char_to_cell.fill(-1); }
+
+    int pinnedCount() const {
+        return static_cast<int>(std::count_if(cell_to_char.begin(), cell_to_char.end(), [](char c) { return c != 0; }));
+    }
+};
+
+// Maps a single ADFGVX character to its row/column index, or -1.
+inline int adfgvxIndex(char c) {
+    switch (c) {
+        case 'A': return 0;
+        case 'D': return 1;
+        case 'F': return 2;
+        case 'G': return 3;
+        case 'V': return 4;
+        case 'X': return 5;
+        default:  return -1;
+    }
+}
+
+// Tries to place one crib at a fixed letter offset in the digraph stream.
+// Identical plaintext letters must map to identical digraphs and distinct letters
+// to distinct digraphs, also with respect to pins from earlier cribs.
+inline bool tryPinCrib(const std::string& digraph_stream, const std::string& crib_text, size_t offset, CribPins& pins) {
+    for (size_t i = 0; i < crib_text.length(); ++i) {
+        size_t p = 2 * (offset + i);
+        int row = adfgvxIndex(digraph_stream[p]);
+        int col = adfgvxIndex(digraph_stream[p + 1]);
+        if (row < 0 || col < 0) return false;
+        int cell = row * 6 + col;
+        unsigned char letter = static_cast<unsigned char>(crib_text[i]);
+
+        if (pins.char_to_cell[letter] >= 0) {
+            if (pins.char_to_cell[letter] != cell) return false;
+        } else {
+            if (pins.cell_to_char[cell] != 0) return false;
+            pins.char_to_cell[letter] = static_cast<signed char>(cell);
+            pins.cell_to_char[cell] = static_cast<char>(letter);
+        }
+    }
+    return true;
+}
+
+// True when letters [offset, offset + length) cross the end of a message. message_ends holds the
+// cumulative end offsets (in letters) of the joined messages; empty means a single message.
+inline bool crossesMessageEnd(const std::vector<size_t>& message_ends, size_t offset, size_t length) {
+    auto end = std::upper_bound(message_ends.begin(), message_ends.end(), offset);
+    return end != message_ends.end() && offset + length > *end;
+}
+
+// Depth-first search over the offsets of every crib. Returns true (and fills `pins`)
+// when all cribs can be placed simultaneously without contradiction.
+inline bool pinCribsFrom(const std::string& digraph_stream, const std::vector<Crib>& cribs, size_t crib_index, CribPins& pins,
+                         const std::vector<size_t>& message_ends = {}) {
+    if (crib_index == cribs.size()) return true;
+
+    const Crib& crib = cribs[crib_index];
+    size_t plain_len = digraph_stream.length() / 2;
+    if (crib.text.length() > plain_len) return false;
+
+    size_t last_start = plain_len - crib.text.length();
+    if (crib.max_pos >= 0) last_start = std::min(last_start, static_cast<size_t>(crib.max_pos));
+
+    for (size_t offset = crib.min_pos; offset <= last_start; ++offset) {
+        if (crossesMessageEnd(message_ends, offset, crib.text.length())) continue;
+        CribPins attempt = pins;
+        if (tryPinCrib(digraph_stream, crib.text, offset, attempt) &&
+            pinCribsFrom(digraph_stream, cribs, crib_index + 1, attempt, message_ends)) {
+            pins = attempt;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Checks whether a transposition's digraph stream is consistent with all cribs.
+// For several messages, pass the stream and message_ends from undoTranspositions.
+inline bool findCribPins(const std::string& digraph_stream, const std::vector<Crib>& cribs, CribPins& pins,
+                         const std::vector<size_t>& message_ends = {}) {
+    pins = CribPins();
+    return pinCribsFrom(digraph_stream, cribs, 0, pins, message_ends);
+}
+
+// Cells the annealer may still permute (all 36 when there are no pins).
+inline std::vector<int> freeCells(const CribPins& pins) {
+    std::vector<int> cells;
+    for (int i = 0; i < 36; ++i) {
+        if (pins.cell_to_char[i] == 0) cells.push_back(i);
+    }
+    return cells;
+}
+
+// Builds a random square that honours the pins; the remaining symbols are shuffled over the free cells.
+inline std::string randomPinnedSquare(const CribPins& pins, Rng& rng) {
+    const std::string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    std::string remaining;
+    for (char c : alphabet) {
+        if (pins.char_to_cell[static_cast<unsigned char>(c)] < 0) remaining += c;
+    }
+    rng.shuffle(remaining);
+
+    std::string square(36, ' ');
+    size_t next = 0;
+    for (int i = 0; i < 36; ++i) {
+        square[i] = pins.cell_to_char[i] != 0 ? pins.cell_to_char[i] : remaining[next++];
+    }
+    return square;
+}
+
+// Warm start: a square from a neighbouring transposition, with the pinned symbols swapped into
+// their cells so it honours this transposition's pins.
+inline std::string pinSquare(std::string square, const CribPins& pins) {
+    for (int i = 0; i < 36; ++i) {
+        char c = pins.cell_to_char[i];
+        if (c == 0 || square[i] == c) continue;
+        std::swap(square[i], square[square.find(c)]);
+    }
+    return square;
+}
+
+#endif // ADFGVX_CRIB_H
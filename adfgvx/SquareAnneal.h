@@ -0,0 +1,119 @@
+#ifndef ADFGVX_SQUAREANNEAL_H
+#define ADFGVX_SQUAREANNEAL_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+#include "ADFGVX.h"
+#include "QuadgramScorer.h"
+#include "../common/Anneal.h"
+
+// Scorer-policy voor het Polybius-vierkant bij een vaste transpositie (zie common/Anneal.h).
+// De transpositie wordt één keer ongedaan gemaakt (setTransposition); per sleutel blijft enkel
+// een tabelopzoeking per digraf over, zonder strings of maps.
+// Strict = true: score_strict (solve_square), anders score_tolerant (find_transposition).
+//
+// Meerdere berichten met dezelfde sleutels (diepte): elk bericht wordt volgens zijn eigen lengte
+// teruggezet (lange/korte kolommen per bericht), de digrafen komen achter elkaar in één buffer,
+// en de score is de som over de berichten. Quadgrams over de grens van twee berichten tellen niet.
+template <bool Strict>
+class SquareScorer {
+public:
+    explicit SquareScorer(const QuadgramScorer& scorer) : scorer(&scorer) {}
+
+    void setTransposition(const std::string& ciphertext, const std::vector<int>& transposition_order) {
+        setTranspositions(&ciphertext, &ciphertext + 1, transposition_order);
+    }
+
+    void setTransposition(const std::vector<std::string>& ciphertexts, const std::vector<int>& transposition_order) {
+        setTranspositions(ciphertexts.data(), ciphertexts.data() + ciphertexts.size(), transposition_order);
+    }
+
+    // false als een van de berichten onder deze transpositie geen geldige digrafen oplevert.
+    bool valid() const { return !cells.empty(); }
+
+    void decode(const std::string& square_key) {
+        uint8_t symbol[36];
+        for (int i = 0; i < 36; ++i) symbol[i] = static_cast<uint8_t>(QuadgramScorer::symbolIndex(square_key[i]));
+        for (size_t k = 0; k < cells.size(); ++k) plaintext[k] = symbol[cells[k]];
+    }
+
+    double score() const {
+        if (cells.empty()) return -1e9;
+        double total = 0.0;
+        size_t begin = 0;
+        for (size_t end : message_ends) {
+            total += Strict ? scorer->scoreSymbolsStrict(plaintext.data() + begin, end - begin)
+                            : scorer->scoreSymbolsTolerant(plaintext.data() + begin, end - begin);
+            begin = end;
+        }
+        return total;
+    }
+
+private:
+    void setTranspositions(const std::string* first, const std::string* last, const std::vector<int>& transposition_order) {
+        cells.clear();
+        message_ends.clear();
+        for (const std::string* ciphertext = first; ciphertext != last; ++ciphertext) {
+            std::vector<uint8_t> message = ADFGVX::digraphCells(*ciphertext, transposition_order);
+            if (message.empty()) {
+                cells.clear();
+                message_ends.clear();
+                break;
+            }
+            cells.insert(cells.end(), message.begin(), message.end());
+            message_ends.push_back(cells.size());
+        }
+        plaintext.resize(cells.size());
+    }
+
+    const QuadgramScorer* scorer;
+    std::vector<uint8_t> cells;
+    std::vector<size_t> message_ends;        // einde van elk bericht in cells
+    std::vector<uint8_t> plaintext;
+};
+
+// De digrafenstromen van alle berichten achter elkaar, elk teruggezet volgens zijn eigen lengte;
+// crib-posities (Crib.h) tellen in deze aaneengeschakelde tekst. message_ends krijgt per bericht
+// de positie (in letters) waar het eindigt, zodat findCribPins geen crib over een grens legt.
+inline std::string undoTranspositions(const std::vector<std::string>& ciphertexts, const std::vector<int>& transposition_order,
+                                      std::vector<size_t>& message_ends) {
+    std::string stream;
+    message_ends.clear();
+    for (const std::string& ciphertext : ciphertexts) {
+        stream += ADFGVX::undoColumnarTransposition(ciphertext, transposition_order);
+        message_ends.push_back(stream.size() / 2);
+    }
+    return stream;
+}
+
+template <bool Strict>
+using SquareAnnealer = Annealer<std::string, PositionMutator, SquareScorer<Strict>, GeometricSchedule>;
+
+// Fase 1 (find_transposition): korte run per transpositie, enkel twee vrije cellen wisselen.
+// T = 20, afkoelen met 0.995, na 2000 stappen zonder record terug naar T = 15.
+inline GeometricSchedule transpositionSchedule() { return GeometricSchedule(20.0, 0.995, 2001, 15.0); }
+
+// Warm start vanuit het vierkant van een naburige transpositie: dat ligt al dicht bij een goed
+// vierkant, dus lager beginnen (T = 5) en herstarten naar T = 3, anders is de structuur meteen weg.
+inline GeometricSchedule warmTranspositionSchedule() { return GeometricSchedule(5.0, 0.995, 2001, 3.0); }
+
+// Fase 1 overloopt de transposities in SJT-volgorde (common/Permutation.h) in blokken van zoveel
+// permutaties: de eerste van een blok start koud, de rest warm vanuit zijn voorganger.
+constexpr uint64_t TRANSPOSITION_BLOCK = 64;
+
+inline SquareAnnealer<false> makeTranspositionAnnealer(const QuadgramScorer& scorer, std::vector<int> free_cells) {
+    return SquareAnnealer<false>(PositionMutator(std::move(free_cells), 100), SquareScorer<false>(scorer),
+                                 transpositionSchedule());
+}
+
+// Fase 2 (solve_square): 60% twee vrije cellen wisselen, anders een stuk van de vrije cellen
+// omkeren. T = 100, afkoelen met 0.999995, geen herstarts.
+inline SquareAnnealer<true> makeSquareAnnealer(const QuadgramScorer& scorer, std::vector<int> free_cells) {
+    return SquareAnnealer<true>(PositionMutator(std::move(free_cells), 60), SquareScorer<true>(scorer),
+                                GeometricSchedule(100.0, 0.999995));
+}
+
+#endif // ADFGVX_SQUAREANNEAL_H
@@ -14,59 +14,70 @@
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <chrono>
+#include <tuple>
+#include <memory>
 
 #include "QuadgramScorer.h"
 #include "ADFGVX.h"
-
-// Struct om het resultaat van een *enkele* permutatie-test op te slaan
-struct PermutationResult {
-    double score;
-    std::vector<int> key;
-
-    // Nodig om te kunnen sorteren
-    bool operator<(const PermutationResult& other) const {
-        return score < other.score;
-    }
+#include "Crib.h"
+#include "SquareAnneal.h"
+#include "../common/Permutation.h"
+#include "../common/ShardFile.h"
+#include "../common/TimeBudget.h"
+#include "../common/ResultRecord.h"
+
+const int TRANSPOSITION_WIDTH = 7;
+
+// Alles wat de threads delen: de (shard van de) sleutelruimte, welke blokken nog moeten,
+// en de shard-toestand waarin elk afgewerkt blok wordt samengevoegd.
+struct SearchJob {
+    const std::vector<std::string>* ciphertexts;  // één of meer berichten met dezelfde sleutels
+    const QuadgramScorer* scorer;
+    const std::vector<Crib>* cribs;
+    int width = TRANSPOSITION_WIDTH;
+    // Permutaties en vastgepinde cellen worden per blok opnieuw gemaakt (permutationFromSjtIndex,
+    // findCribPins): ze voor de hele shard bijhouden kost op breedte 12 meer dan 100 GB.
+    // Met cribs onthoudt het crib-filter enkel één bit per SJT-index (index - range_begin).
+    std::vector<bool> active;                     // leeg = geen cribs, alles actief
+    size_t active_total = 0;
+
+    bool isActive(uint64_t index) const { return active.empty() || active[index - state.range_begin]; }
+
+    std::vector<uint64_t> pending_blocks;
+    std::atomic<size_t> next_pending{0};
+
+    ShardState state;
+    std::string state_path;                       // leeg = niets wegschrijven
+    int iterations_per_permutation = 20000;       // SA-iteraties op het vierkant per transpositie (koude start)
+    int warm_iterations = 5000;                   // idem bij een warme start (0 = altijd koud starten)
+    int cache_bits = 0;                           // score-cache per thread, 2^bits sleutels (0 = uit)
+    bool pin_threads = false;                     // --pin-threads: thread i vast op een CPU (TablePlacement.h)
+    uint64_t seed = 0;                            // elke permutatie krijgt de stroom Rng(seed, SJT-index)
+    double time_budget = 0.0;                     // --time-budget in seconden (0 = vaste iteraties)
+    std::atomic<size_t> permutations_left{0};     // actieve permutaties in blokken die nog niemand nam
+    std::atomic<bool> budget_stopped{false};      // blokken overgeslagen door budget of signaal
+    double resumed_seconds = 0.0;
+    std::chrono::steady_clock::time_point started;
+
+    ResultWriter* results = nullptr;              // --results: records voor de pipeline (ResultRecord.h)
+    ResultRecord record_template;                 // solver, model, invoer en seed; top en tellers per record
+    size_t results_top = 10;
 };
 
 // Gedeelde data voor de threads
 std::mutex cout_mutex;
+std::mutex state_mutex;
 std::atomic<int> permutations_processed(0);
+std::atomic<long long> sa_iterations_done(0);
 std::atomic<double> best_overall_score(-999999.0);
 
-// Functie om morse code te converteren
-std::string convertMorseToADFGVX(const std::string& morse_code) {
-    const std::map<std::string, char> morse_map = {
-        {".-",   'A'}, {"-..",  'D'}, {"..-.", 'F'},
-        {"--.",  'G'}, {"...-", 'V'}, {"-..-", 'X'}
-    };
-
-    std::string adfgvx_text;
-    std::string current_morse_char;
-
-    for (char c : morse_code) {
-        if (c == '.' || c == '-') {
-            current_morse_char += c;
-        } else if (c == '/') {
-            if (!current_morse_char.empty()) {
-                if (morse_map.count(current_morse_char)) {
-                    adfgvx_text += morse_map.at(current_morse_char);
-                }
-                current_morse_char.clear();
-            }
-        }
-        // Negeer alle andere karakters (spaties, newlines, etc.)
-    }
-
-    // Vergeet het laatste karakter niet als het bestand niet eindigt op een '/'
-    if (!current_morse_char.empty()) {
-        if (morse_map.count(current_morse_char)) {
-            adfgvx_text += morse_map.at(current_morse_char);
-        }
-    }
-
-    return adfgvx_text;
-}
+// Naam in de shard-bestanden. De blokken volgen de SJT-volgorde; shard-bestanden uit de tijd van de
+// lexicografische volgorde ("adfgvx_find_transposition") worden daardoor geweigerd in plaats van
+// verkeerd hervat.
+const std::string SHARD_SOLVER = "adfgvx_find_transposition_sjt";
+AnnealProfile anneal_profile;                     // enkel gevuld met CODETHEORIE_PROFILE (onder state_mutex)
+ScoreCacheStats cache_stats;                      // opgeteld over de threads (onder state_mutex)
 
 // Functie om bestand te laden
 std::string loadFileContent(const std::string& filepath) {
@@ -81,115 +92,373 @@ std::string loadFileContent(const std::string& filepath) {
     return text;
 }
 
+// Simulated annealing op het Polybius-vierkant voor één vaste transpositie (common/Anneal.h).
+// Geeft het beste vierkant en zijn (tolerante) quadgram-score terug. Met een warm_square (het beste
+// vierkant van de vorige, naburige transpositie) start de zoektocht daar, koeler en korter.
+AnnealResult<std::string> anneal_square_for_permutation(SquareAnnealer<false>& annealer, Rng& rng, const std::vector<std::string>& ciphertexts,
+                                                        const std::vector<int>& current_transpo_perm, const CribPins& pins,
+                                                        const std::string& warm_square, int iterations_per_permutation) {
+
+    // Zonder cribs zijn alle 36 cellen vrij; met cribs liggen sommige cellen vast.
+    annealer.mutator() = PositionMutator(freeCells(pins), 100);
+    annealer.scorer().setTransposition(ciphertexts, current_transpo_perm);
+    annealer.clearScoreCache();                  // andere transpositie: de oude scores gelden niet meer
+    bool searchable = annealer.mutator().canMove() && annealer.scorer().valid();
+    int iterations = searchable ? iterations_per_permutation : 0;
+    sa_iterations_done += iterations;
+
+    bool warm = !warm_square.empty();
+    annealer.schedule() = warm ? warmTranspositionSchedule() : transpositionSchedule();
+    std::string square_key = warm ? pinSquare(warm_square, pins) : randomPinnedSquare(pins, rng);
+    return annealer.run(square_key, rng, iterations);
+}
+
+// Tijdsbudget: iteraties per permutatie (koud, warm) voor het volgende blok, zodat de permutaties die
+// nog over zijn het resterende budget vullen aan de snelheid van tot nu toe (alle threads samen).
+// Een warme start kost warm/koud zoveel als een koude; het eerste blok van de run meet de snelheid.
+std::pair<int, int> budgeted_iterations(const SearchJob* job, double elapsed) {
+    int cold = job->iterations_per_permutation;
+    int warm = job->warm_iterations;
+    double rate = elapsed > 0.5 ? sa_iterations_done / elapsed : 0.0;
+    size_t left = job->permutations_left;
+    if (rate <= 0.0 || left == 0 || cold <= 0) return {cold, warm};
+
+    double warm_ratio = static_cast<double>(warm) / cold;
+    double block = static_cast<double>(TRANSPOSITION_BLOCK);
+    double cost_per_permutation = (1.0 + (block - 1.0) * warm_ratio) / block;
+    double per_permutation = rate * std::max(0.0, job->time_budget - elapsed) / (left * cost_per_permutation);
+    int budgeted = static_cast<int>(std::clamp(per_permutation, 100.0, 1e9));
+    return {budgeted, static_cast<int>(budgeted * warm_ratio)};
+}
+
+// Gestructureerde record met de top-K transposities. Fase 1 bewaart per transpositie enkel de score,
+// niet het vierkant, dus de kandidaten hebben geen plaintext: die komt uit solve_square.
+// Onder state_mutex oproepen (of nadat de threads klaar zijn).
+void submit_record(const SearchJob* job, const std::string& status, double elapsed) {
+    if (!job->results) return;
+    ResultRecord record = job->record_template;
+    record.status = status;
+    record.iterations = sa_iterations_done;
+    record.seconds = elapsed;
+    uint64_t done = std::count(job->state.done_blocks.begin(), job->state.done_blocks.end(), true);
+    record.addInfo("blocks_done", done).addInfo("blocks_total", job->state.numBlocks());
+    const auto& ranked = job->state.top.ranked();
+    for (size_t i = 0; i < std::min(job->results_top, ranked.size()); ++i) {
+        record.top.push_back({ranked[i].score, keyText(ranked[i].key), ""});
+    }
+    job->results->submit(std::move(record));
+}
+
+// Op SIGUSR1: de huidige top 5 (na het eerstvolgende afgewerkte blok). Onder state_mutex oproepen.
+void publish_top_keys(const SearchJob* job, double elapsed) {
+    std::lock_guard<std::mutex> lock(cout_mutex);
+    std::cout << "--- Tussenstand na " << elapsed << " s (" << permutations_processed << "/" << job->active_total
+              << " permutaties) ---" << std::endl;
+    const auto& ranked = job->state.top.ranked();
+    for (size_t i = 0; i < std::min((size_t)5, ranked.size()); ++i) {
+        std::cout << " #" << i + 1 << ": Score = " << ranked[i].score << " | Sleutel: ";
+        for (int k : ranked[i].key) std::cout << k << " ";
+        std::cout << std::endl;
+    }
+}
+
 // DE FUNCTIE DIE ELKE THREAD UITVOERT
-void worker_function(int thread_id, const std::string* ciphertext, const QuadgramScorer* scorer,
-                     const std::vector<std::vector<int>>* all_permutations, size_t start_index, size_t end_index,
-                     std::vector<PermutationResult>* thread_results) {
+// Elke thread neemt telkens het volgende onafgewerkte blok van de sleutelruimte (dynamische verdeling).
+// Binnen een blok verschillen opeenvolgende permutaties (SJT-volgorde) in één naburige wissel van
+// kolommen; de digrafenstroom blijft dan grotendeels gelijk, dus elke permutatie start warm vanuit
+// het beste vierkant van de vorige. De eerste van elk blok start koud, zodat een blok een
+// zelfstandige werkeenheid blijft (threads, shards, hervatten). De blokken liggen op globale
+// veelvouden van TRANSPOSITION_BLOCK (ook de shard-grenzen, zie newShardState), zoals in de daemon:
+// de score van een permutatie hangt dus niet af van de shard-indeling.
+void worker_function(int thread_id, SearchJob* job) {
+    if (job->pin_threads) {
+        int cpu = pinCurrentThread(static_cast<unsigned>(thread_id));
+        std::lock_guard<std::mutex> lock(cout_mutex);
+        if (cpu >= 0) std::cout << "[Thread " << thread_id << "] vastgepind op CPU " << cpu << " (knoop " << currentNumaNode() << ")" << std::endl;
+        else std::cout << "[Thread " << thread_id << "] vastpinnen lukt niet, de thread blijft vrij" << std::endl;
+    }
 
-    ADFGVX cipher;
-    std::mt19937  rng(std::random_device{}() + thread_id);
-    const int ITERATIONS_PER_PERMUTATION = 20000;
+    // Eén annealer per thread (instellingen in SquareAnneal.h).
+    SquareAnnealer<false> annealer = makeTranspositionAnnealer(*job->scorer, freeCells(CribPins()));
+    annealer.enableScoreCache(job->cache_bits);
 
     // --- NIEUW: Variabelen om het lokale record van deze thread bij te houden ---
     double best_score_in_thread = -999999.0;
     std::vector<int> best_key_in_thread;
     // --- EINDE NIEUW ---
 
-    for (size_t i = start_index; i < end_index; ++i) {
-        const auto& current_transpo_perm = (*all_permutations)[i];
+    while (true) {
+        size_t pending_index = job->next_pending++;
+        if (pending_index >= job->pending_blocks.size()) break;
+        uint64_t block = job->pending_blocks[pending_index];
+        auto [block_begin, block_end] = job->state.blockRange(block);
+
+        // Met een tijdsbudget: stoppen als het op is (of bij Ctrl-C); de overige blokken blijven open
+        // in het shard-bestand. Anders de iteraties afstemmen op de resterende tijd.
+        int cold_iterations = job->iterations_per_permutation;
+        int warm_iterations = job->warm_iterations;
+        if (job->time_budget > 0.0) {
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - job->started).count();
+            if (stopRequested() || elapsed >= job->time_budget) {
+                job->budget_stopped = true;
+                break;
+            }
+            std::tie(cold_iterations, warm_iterations) = budgeted_iterations(job, elapsed);
+            size_t block_active = 0;
+            for (uint64_t index = block_begin; index < block_end; ++index) block_active += job->isActive(index);
+            job->permutations_left -= block_active;
+        }
 
-        std::string parent_square_key = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
-        std::shuffle(parent_square_key.begin(), parent_square_key.end(), rng);
+        std::vector<ShardCandidate> block_results;
+        uint64_t block_tested = 0;
+        std::string warm_square;                     // beste vierkant van de vorige permutatie in dit blok
+
+        CribPins pins;
+        for (uint64_t index = block_begin; index < block_end; ++index) {
+            if (index % TRANSPOSITION_BLOCK == 0) warm_square.clear();
+            if (!job->isActive(index)) continue;
+            const std::vector<int> current_transpo_perm = permutationFromSjtIndex(job->width, index);
+            if (!job->cribs->empty()) {
+                std::vector<size_t> message_ends;
+                std::string stream = undoTranspositions(*job->ciphertexts, current_transpo_perm, message_ends);
+                findCribPins(stream, *job->cribs, pins, message_ends);
+            }
+            // Eigen stroom per index: de score van een permutatie hangt niet af van de thread,
+            // het aantal threads of de shard-indeling.
+            Rng rng(job->seed, index);
+
+            bool warm = warm_iterations > 0 && !warm_square.empty();
+            auto result = anneal_square_for_permutation(
+                    annealer, rng, *job->ciphertexts, current_transpo_perm, pins,
+                    warm ? warm_square : std::string(), warm ? warm_iterations : cold_iterations);
+            if (result.iterations > 0) warm_square = result.best;
+            double best_score_for_this_perm = result.best_score;
+            block_results.push_back({best_score_for_this_perm, current_transpo_perm});
+            block_tested++;
+
+            // --- NIEUW: Check en print voor lokaal record van de thread ---
+            if (best_score_for_this_perm > best_score_in_thread) {
+                best_score_in_thread = best_score_for_this_perm;
+                best_key_in_thread = current_transpo_perm;
+
+                // Gebruik de mutex om de output netjes te houden
+                std::lock_guard<std::mutex> lock(cout_mutex);
+                std::cout << "[Thread " << thread_id << "] Nieuw LOKAAL record! Score: " << best_score_in_thread << " met sleutel: ";
+                for(int k : best_key_in_thread) std::cout << k << " ";
+                std::cout << std::endl;
+            }
+            // --- EINDE NIEUW ---
+
+            // --- DUBBELE FEEDBACK LOGICA (voor globaal record) ---
+            double current_best = best_overall_score;
+            if (best_score_for_this_perm > current_best) {
+                if (best_overall_score.compare_exchange_strong(current_best, best_score_for_this_perm)) {
+                    std::lock_guard<std::mutex> lock(cout_mutex);
+                    std::cout << ">>> [Thread " << thread_id << "] NIEUW ALGEMEEN RECORD! Score: " << best_score_for_this_perm << " met sleutel: ";
+                    for(int k : current_transpo_perm) std::cout << k << " ";
+                    std::cout << " <<<" << std::endl;
+                }
+            }
 
-        cipher.setKeys(parent_square_key, current_transpo_perm);
-        std::string parent_plain = cipher.decrypt(*ciphertext);
-        double parent_score = parent_plain.empty() ? -1e9 : scorer->score_tolerant(parent_plain);
-        double best_score_for_this_perm = parent_score;
+            permutations_processed++;
+            if (permutations_processed % 100 == 0) {
+                std::lock_guard<std::mutex> lock(cout_mutex);
+                std::cout << "Progress: " << permutations_processed << "/" << job->active_total << "... (Huidig record: " << best_overall_score << ")" << std::endl;
+            }
+        }
 
-        double temperature = 20.0;
-        double cooling_rate = 0.995;
-        int stagnation_counter = 0;
-        const int stagnation_limit = 2000;
+        // Blok afgewerkt: samenvoegen in de shard-toestand en (indien gevraagd) checkpointen.
+        std::lock_guard<std::mutex> lock(state_mutex);
+        for (const auto& r : block_results) job->state.top.add(r);
+        job->state.done_blocks[block] = true;
+        job->state.counters["permutations_tested"] += block_tested;
+        job->state.counters["sa_runs"] += block_tested;
+        job->state.elapsed_seconds = job->resumed_seconds +
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - job->started).count();
+        if (!job->state_path.empty()) saveShardState(job->state, job->state_path);
+        if (takePublishRequest()) {
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - job->started).count();
+            publish_top_keys(job, elapsed);
+            submit_record(job, "interim", elapsed);
+        }
+    }
+    std::lock_guard<std::mutex> lock(state_mutex);
+    if constexpr (ANNEAL_PROFILE) anneal_profile += annealer.profile();
+    cache_stats += annealer.cacheStats();
+}
 
-        for(int j = 0; j < ITERATIONS_PER_PERMUTATION; ++j) {
-            std::string child_square_key = parent_square_key;
+// De instellingen die de score per transpositie bepalen, voor het shard-bestand: hervatten of
+// samenvoegen met een ander bericht (of een ander aantal berichten: een som over berichten heeft een
+// andere schaal), andere cribs, een ander model, andere iteraties of een andere seed wordt geweigerd.
+// De berichten staan erin als vingerafdruk van hun ADFGVX-tekst, dus niet als pad.
+std::string transposition_settings(const std::vector<std::string>& ciphertexts, const std::vector<Crib>& cribs,
+                                   const std::string& model, int width, int iterations, int warm_iterations, uint64_t seed) {
+    std::ostringstream out;
+    out << "model=" << model << " width=" << width << " iterations=" << iterations << " warm_iterations=" << warm_iterations
+        << " seed=" << seed << " messages=";
+    for (size_t m = 0; m < ciphertexts.size(); ++m) out << (m ? "," : "") << textFingerprint(ciphertexts[m]);
+    out << " cribs=";
+    for (size_t c = 0; c < cribs.size(); ++c) {
+        out << (c ? "," : "") << cribs[c].text << "@" << cribs[c].min_pos << "-" << cribs[c].max_pos;
+    }
+    return out.str();
+}
 
-            int a = std::uniform_int_distribution<int>(0, 35)(rng);
-            int b = std::uniform_int_distribution<int>(0, 35)(rng);
-            std::swap(child_square_key[a], child_square_key[b]);
+// Print de top 10 en schrijft ze weg naar best_transpo_key.txt (invoer voor solve_square).
+void report_top_keys(const std::vector<ShardCandidate>& ranked) {
+    std::cout << "Top 10 beste transpositie-sleutels gevonden:\n" << std::endl;
 
-            cipher.setKeys(child_square_key, current_transpo_perm);
-            std::string child_plain = cipher.decrypt(*ciphertext);
-            if (child_plain.empty()) continue;
+    for(size_t i = 0; i < std::min((size_t)10, ranked.size()); ++i) {
+        std::cout << " #" << i + 1 << ": Score = " << ranked[i].score << " | Sleutel: ";
+        for(int k : ranked[i].key) {
+            std::cout << k << " ";
+        }
+        std::cout << std::endl;
+    }
 
-            double child_score = scorer->score_tolerant(child_plain);
-            if (child_score > parent_score || exp((child_score - parent_score) / temperature) > std::uniform_real_distribution<>(0.0, 1.0)(rng)) {
-                parent_score = child_score; parent_square_key = child_square_key;
+    // Sla de top 10 op in het bestand
+    std::ofstream key_file("best_transpo_key.txt");
+    if (key_file.is_open()) {
+        for(size_t i = 0; i < std::min((size_t)10, ranked.size()); ++i) {
+            for (size_t j = 0; j < ranked[i].key.size(); ++j) {
+                key_file << ranked[i].key[j] << (j == ranked[i].key.size() - 1 ? "" : " ");
             }
+            key_file << std::endl;
+        }
+        key_file.close();
+        std::cout << "\nTop 10 beste sleutels zijn opgeslagen in best_transpo_key.txt" << std::endl;
+        std::cout << "De eerste (beste) sleutel in dit bestand zal worden gebruikt door solve_square." << std::endl;
+    }
+}
 
-            if (parent_score > best_score_for_this_perm) {
-                best_score_for_this_perm = parent_score;
-                stagnation_counter = 0;
+int main(int argc, char* argv[]) {
+    try {
+        // Optioneel: --crib TEKST[@start[-eind]] (herhaalbaar) om transposities te snoeien.
+        // Sharding:  --shard i/N [--out bestand] [--top K]   (herstartbaar via het shard-bestand)
+        // Samenvoegen: --merge shard0.txt shard1.txt ...
+        // Andere invoer (o.a. bench/solve_bench): --in morsebestand, --width N, --model naam,
+        // --iterations N (per transpositie), --seed N.
+        // Diepte: --in meermaals = berichten met dezelfde sleutels, samen gescoord.
+        // Veel kernen: --huge-pages off|thp|explicit, --numa-replicate (kopie van de quadgramtabel per
+        // NUMA-knoop) en --pin-threads (common/TablePlacement.h).
+        // Anytime: --time-budget S stemt de iteraties per transpositie af op S seconden (common/TimeBudget.h).
+        // --results PREFIX [--results-top K]: gestructureerde record naar PREFIX.jsonl/.bin (common/ResultRecord.h),
+        // plus een tussentijdse record bij elke SIGUSR1.
+        std::vector<Crib> cribs;
+        // Start vanuit de map adfgvx/ zodat basePath klopt.
+        std::filesystem::path basePath = "../";
+        std::vector<std::string> ciphertext_paths;
+        std::string model_name = "spaceless_english";
+        int width = TRANSPOSITION_WIDTH;
+        int iterations_per_permutation = 20000;
+        int warm_iterations = -1;             // standaard een vierde van --iterations
+        int cache_bits = 0;
+        uint64_t seed = randomSeed();
+        double time_budget = 0.0;
+        TablePlacement placement;
+        std::string results_prefix;
+        size_t results_top = 10;
+        bool pin_threads = false;
+        // Met CODETHEORIE_PROFILE: fase-profiel van alle threads samen (common/AnnealProfile.h).
+        std::string profile_path = "anneal_profile.json";
+        ShardSpec shard;
+        bool sharded = false;
+        std::string out_path;
+        size_t top_k = 100;
+        std::vector<std::string> merge_paths;
+        for (int a = 1; a < argc; ++a) {
+            std::string arg = argv[a];
+            if (arg == "--crib" && a + 1 < argc) {
+                cribs.push_back(parseCrib(argv[++a]));
+            } else if (arg == "--shard" && a + 1 < argc) {
+                shard = parseShardSpec(argv[++a]);
+                sharded = true;
+            } else if (arg == "--out" && a + 1 < argc) {
+                out_path = argv[++a];
+            } else if (arg == "--top" && a + 1 < argc) {
+                top_k = std::stoul(argv[++a]);
+            } else if (arg == "--in" && a + 1 < argc) {
+                ciphertext_paths.push_back(argv[++a]);
+            } else if (arg == "--width" && a + 1 < argc) {
+                width = std::stoi(argv[++a]);
+                if (width < 2 || width > 12) throw std::invalid_argument("--width moet tussen 2 en 12 liggen.");
+            } else if (arg == "--model" && a + 1 < argc) {
+                model_name = argv[++a];
+            } else if (arg == "--iterations" && a + 1 < argc) {
+                iterations_per_permutation = std::stoi(argv[++a]);
+            } else if (arg == "--warm-iterations" && a + 1 < argc) {
+                warm_iterations = std::stoi(argv[++a]);
+            } else if (arg == "--cache" && a + 1 < argc) {
+                cache_bits = std::stoi(argv[++a]);
+            } else if (arg == "--profile" && a + 1 < argc) {
+                profile_path = argv[++a];
+                if (!ANNEAL_PROFILE) std::cerr << "Let op: --profile werkt enkel als gecompileerd met CODETHEORIE_PROFILE." << std::endl;
+            } else if (arg == "--results" && a + 1 < argc) {
+                results_prefix = argv[++a];
+            } else if (arg == "--results-top" && a + 1 < argc) {
+                results_top = std::stoul(argv[++a]);
+            } else if (arg == "--seed" && a + 1 < argc) {
+                seed = std::stoull(argv[++a]);
+            } else if (arg == "--time-budget" && a + 1 < argc) {
+                time_budget = std::stod(argv[++a]);
+            } else if (arg == "--huge-pages" && a + 1 < argc) {
+                placement.huge_pages = parseHugePages(argv[++a]);
+            } else if (arg == "--numa-replicate") {
+                placement.numa_replicate = true;
+            } else if (arg == "--pin-threads") {
+                pin_threads = true;
+            } else if (arg == "--merge") {
+                while (a + 1 < argc) merge_paths.push_back(argv[++a]);
             } else {
-                stagnation_counter++;
-            }
-            temperature *= cooling_rate;
-            if(stagnation_counter > stagnation_limit){
-                temperature = 15.0;
-                stagnation_counter = 0;
+                throw std::invalid_argument("Onbekend argument: " + arg +
+                    " (gebruik: [--crib TEKST[@start[-eind]]] [--shard i/N [--out bestand] [--top K]]"
+                    " [--in bestand]... [--width N] [--model naam] [--iterations N] [--warm-iterations N] [--time-budget S] [--seed N] [--cache BITS] [--huge-pages off|thp|explicit] [--numa-replicate] [--pin-threads] [--results prefix [--results-top K]] [--profile bestand] | --merge bestanden...)");
             }
         }
 
-        thread_results->push_back({best_score_for_this_perm, current_transpo_perm});
-
-        // --- NIEUW: Check en print voor lokaal record van de thread ---
-        if (best_score_for_this_perm > best_score_in_thread) {
-            best_score_in_thread = best_score_for_this_perm;
-            best_key_in_thread = current_transpo_perm;
+        std::cout << std::fixed << std::setprecision(2);
 
-            // Gebruik de mutex om de output netjes te houden
-            std::lock_guard<std::mutex> lock(cout_mutex);
-            std::cout << "[Thread " << thread_id << "] Nieuw LOKAAL record! Score: " << best_score_in_thread << " met sleutel: ";
-            for(int k : best_key_in_thread) std::cout << k << " ";
+        if (!merge_paths.empty()) {
+            MergedShards merged = mergeShardFiles(merge_paths, SHARD_SOLVER);
+            std::cout << "--- SHARDS SAMENGEVOEGD ---" << std::endl;
+            std::cout << merged.shards_seen << " van " << merged.shard_count << " shards, "
+                      << merged.counters["permutations_tested"] << " permutaties getest, "
+                      << "rekentijd " << merged.total_seconds << " s (traagste shard " << merged.slowest_shard_seconds << " s)." << std::endl;
+            if (merged.shards_seen < merged.shard_count || merged.incomplete_shards > 0) {
+                std::cout << "LET OP: " << merged.shard_count - merged.shards_seen << " shard(s) ontbreken en "
+                          << merged.incomplete_shards << " shard(s) zijn nog niet klaar; de ranking is onvolledig." << std::endl;
+            }
             std::cout << std::endl;
+            report_top_keys(merged.top.ranked());
+            return 0;
         }
-        // --- EINDE NIEUW ---
 
-        // --- DUBBELE FEEDBACK LOGICA (voor globaal record) ---
-        double current_best = best_overall_score;
-        if (best_score_for_this_perm > current_best) {
-            if (best_overall_score.compare_exchange_strong(current_best, best_score_for_this_perm)) {
-                std::lock_guard<std::mutex> lock(cout_mutex);
-                std::cout << ">>> [Thread " << thread_id << "] NIEUW ALGEMEEN RECORD! Score: " << best_score_for_this_perm << " met sleutel: ";
-                for(int k : current_transpo_perm) std::cout << k << " ";
-                std::cout << " <<<" << std::endl;
-            }
+        if (sharded && out_path.empty()) {
+            out_path = "shard_" + std::to_string(shard.index) + "_of_" + std::to_string(shard.count) + ".txt";
         }
 
-        permutations_processed++;
-        if (permutations_processed % 100 == 0) {
-            std::lock_guard<std::mutex> lock(cout_mutex);
-            std::cout << "Progress: " << permutations_processed << "/" << all_permutations->size() << "... (Huidig record: " << best_overall_score << ")" << std::endl;
-        }
-    }
-}
-
-int main() {
-    try {
-        // Start vanuit de map adfgvx/ zodat basePath klopt.
-        std::filesystem::path basePath = "../";
-        std::string ciphertext_path = (basePath / "adfgvx" / "03-OPGAVE-adfgvx.txt").string();
-        std::string quadgrams_path = (basePath / "data" / "spaceless_english_quadgrams.txt").string();
+        std::string quadgrams_path = (basePath / "data" / (model_name + "_quadgrams.txt")).string();
 
         std::cout << "Laden van quadgrams van: " << quadgrams_path << std::endl;
         QuadgramScorer scorer(quadgrams_path);
-        std::cout << "Laden van morse code van: " << ciphertext_path << std::endl;
-        std::string morse_ciphertext = loadFileContent(ciphertext_path);
-        std::string ciphertext = convertMorseToADFGVX(morse_ciphertext);
-        if (ciphertext.length() % 2 != 0) { ciphertext.pop_back(); }
-        std::cout << "Morse code omgezet naar ADFGVX ciphertext (" << ciphertext.length() << " tekens).\n" << std::endl;
-
-        std::cout << std::fixed << std::setprecision(2);
+        if (placement.enabled()) {
+            scorer.placeTable(placement);
+            std::cout << "Quadgramtabel: " << scorer.describeTablePlacement() << " (" << numaNodeCount() << (numaNodeCount() == 1 ? " NUMA-knoop)" : " NUMA-knopen)") << std::endl;
+        }
+        if (ciphertext_paths.empty()) ciphertext_paths.push_back((basePath / "adfgvx" / "03-OPGAVE-adfgvx.txt").string());
+        std::vector<std::string> ciphertexts;
+        for (const std::string& ciphertext_path : ciphertext_paths) {
+            std::cout << "Laden van morse code van: " << ciphertext_path << std::endl;
+            std::string ciphertext = morseToADFGVX(loadFileContent(ciphertext_path));
+            if (ciphertext.length() % 2 != 0) { ciphertext.pop_back(); }
+            std::cout << "Morse code omgezet naar ADFGVX ciphertext (" << ciphertext.length() << " tekens)." << std::endl;
+            ciphertexts.push_back(ciphertext);
+        }
+        if (ciphertexts.size() > 1) {
+            std::cout << ciphertexts.size() << " berichten met dezelfde sleutels: elk wordt volgens zijn eigen lengte"
+                      << " teruggezet, de score is de som over de berichten." << std::endl;
+        }
+        std::cout << std::endl;
 
         std::cout << "--- FASE 1: Starten van PARALLELLE, GRONDIGE brute-force aanval op transpositie-sleutel ---" << std::endl;
 
@@ -198,68 +467,151 @@ unsigned int num_threads = std::thread::hardware_concurrency();
             num_threads = 1;
         }
 
-        std::vector<std::vector<int>> all_permutations;
-        std::vector<int> p = {0, 1, 2, 3, 4, 5, 6};
-        do {
-            all_permutations.push_back(p);
-        } while (std::next_permutation(p.begin(), p.end()));
+        // De sleutelruimte wordt op SJT-index verdeeld; zonder --shard is dit shard 0/1.
+        const uint64_t BLOCK_SIZE = TRANSPOSITION_BLOCK;
+        SearchJob job;
+        job.ciphertexts = &ciphertexts;
+        job.scorer = &scorer;
+        job.cribs = &cribs;
+        job.width = width;
+        job.iterations_per_permutation = iterations_per_permutation;
+        job.warm_iterations = warm_iterations >= 0 ? warm_iterations : iterations_per_permutation / 4;
+        job.cache_bits = cache_bits;
+        job.seed = seed;
+        job.time_budget = time_budget;
+        job.pin_threads = pin_threads;
+        job.state = newShardState(SHARD_SOLVER, factorial(width), shard, BLOCK_SIZE, top_k, true);
+        job.state.settings = transposition_settings(ciphertexts, cribs, model_name, width, job.iterations_per_permutation,
+                                                    job.warm_iterations, seed);
+        job.state_path = out_path;
+        std::unique_ptr<ResultWriter> results;
+        if (!results_prefix.empty()) {
+            results = std::make_unique<ResultWriter>(results_prefix);
+            job.results = results.get();
+            job.results_top = results_top;
+            job.record_template.solver = "find_transposition_adfgvx";
+            job.record_template.model = model_name;
+            for (size_t m = 0; m < ciphertext_paths.size(); ++m) job.record_template.input += (m ? "," : "") + ciphertext_paths[m];
+            job.record_template.seed = seed;
+            job.record_template.addInfo("width", width);
+            if (sharded) job.record_template.addInfo("shard", std::to_string(shard.index) + "/" + std::to_string(shard.count));
+        }
 
-        size_t total_perms = all_permutations.size();
-        std::cout << total_perms << " permutaties gegenereerd om te testen." << std::endl;
+        if (!out_path.empty()) {
+            ShardState previous;
+            if (loadShardState(out_path, previous)) {
+                if (!sameShardLayout(previous, job.state)) {
+                    throw std::runtime_error("Bestaand shard-bestand " + out_path + " hoort bij een andere shard-configuratie.");
+                }
+                if (!sameShardSettings(previous, job.state)) {
+                    throw std::runtime_error(settingsMismatch(out_path, previous.settings, job.state.settings));
+                }
+                job.state = previous;
+                job.resumed_seconds = previous.elapsed_seconds;
+                std::cout << "Hervatten vanuit " << out_path << std::endl;
+            }
+        }
+
+        // De sleutelruimte loopt in SJT-volgorde (zie worker_function), niet lexicografisch.
+        uint64_t range_size = job.state.range_end - job.state.range_begin;
+        std::cout << range_size << " permutaties te testen";
+        if (sharded) std::cout << " (shard " << shard.index << "/" << shard.count << ", indexen " << job.state.range_begin << "-" << job.state.range_end - 1 << ")";
+        std::cout << "." << std::endl;
+        std::cout << "Seed " << seed << " (--seed " << seed << " herhaalt deze run)." << std::endl;
+
+        // Crib-filter: gooi transposities weg waarvan de digraafstroom niet consistent is met de cribs.
+        // Welke vierkant-cellen vastliggen, rekent de worker per blok opnieuw uit.
+        job.active_total = range_size;
+        if (!cribs.empty()) {
+            job.active.assign(range_size, false);
+            job.active_total = 0;
+            for (uint64_t index = job.state.range_begin; index < job.state.range_end; ++index) {
+                std::vector<int> perm = permutationFromSjtIndex(width, index);
+                std::vector<size_t> message_ends;
+                std::string stream = undoTranspositions(ciphertexts, perm, message_ends);
+                CribPins pins;
+                if (!findCribPins(stream, cribs, pins, message_ends)) continue;
+                job.active[index - job.state.range_begin] = true;
+                if (job.active_total < 20) {
+                    std::cout << "  Sleutel: ";
+                    for (int k : perm) std::cout << k << " ";
+                    std::cout << "| " << pins.pinnedCount() << " cellen vastgepind" << std::endl;
+                }
+                job.active_total++;
+            }
+            std::cout << "Crib-filter: " << job.active_total << " van " << range_size
+                      << " permutaties zijn consistent met " << cribs.size() << " crib(s)." << std::endl;
+            if (job.active_total == 0) {
+                std::cout << "Geen enkele permutatie is consistent met de cribs." << std::endl;
+            }
+        }
+
+        for (uint64_t b = 0; b < job.state.numBlocks(); ++b) {
+            if (job.state.done_blocks[b]) continue;
+            job.pending_blocks.push_back(b);
+            auto [block_begin, block_end] = job.state.blockRange(b);
+            for (uint64_t index = block_begin; index < block_end; ++index) job.permutations_left += job.isActive(index);
+        }
+        if (job.pending_blocks.size() < job.state.numBlocks()) {
+            std::cout << job.state.numBlocks() - job.pending_blocks.size() << " van " << job.state.numBlocks()
+                      << " blokken waren al afgewerkt en worden overgeslagen." << std::endl;
+        }
 
         // Bepaal het daadwerkelijke aantal te gebruiken threads (veiligheidscheck)
-        unsigned int threads_to_use = std::min<unsigned int>(num_threads, static_cast<unsigned int>(total_perms));
-        std::cout << "Detecteerde " << num_threads << " threads, gebruiken er " << threads_to_use << "." << std::endl;
+        unsigned int threads_to_use = std::max<unsigned int>(1, std::min<unsigned int>(num_threads, static_cast<unsigned int>(job.pending_blocks.size())));
+        std::cout << "Detecteerde " << num_threads << " threads, gebruiken er " << threads_to_use
+                  << " (" << job.pending_blocks.size() << " blokken van " << BLOCK_SIZE << " permutaties)." << std::endl;
+
+        if (time_budget > 0.0) {
+            installAnytimeSignals();
+            std::cout << "Tijdsbudget " << time_budget << " s: iteraties per transpositie volgen de gemeten snelheid."
+                      << " SIGUSR1 toont de tussenstand, Ctrl-C stopt na het lopende blok." << std::endl;
+        }
 
+        job.started = std::chrono::steady_clock::now();
         std::vector<std::thread> threads;
-        std::vector<std::vector<PermutationResult>> results_per_thread(threads_to_use);
-        size_t chunk_size = total_perms / threads_to_use;
-        std::cout << "Elke thread verwerkt circa " << chunk_size << " permutaties." << std::endl;
-
         for (unsigned int i = 0; i < threads_to_use; ++i) {
-            size_t start = i * chunk_size;
-            // Gebruik 'threads_to_use' voor de check van de laatste thread
-            size_t end = (i == threads_to_use - 1) ? total_perms : start + chunk_size;
-
-            threads.emplace_back(worker_function, i, &ciphertext, &scorer, &all_permutations, start, end, &results_per_thread[i]);
+            threads.emplace_back(worker_function, i, &job);
         }
 
         for (auto& t : threads) {
             t.join();
         }
-
-        // Verzamel alle resultaten in één grote lijst
-        std::vector<PermutationResult> all_results;
-        for(const auto& thread_res : results_per_thread) {
-            all_results.insert(all_results.end(), thread_res.begin(), thread_res.end());
-        }
-
-        // Sorteer de lijst van beste naar slechtste score
-        std::sort(all_results.rbegin(), all_results.rend());
+        if (!out_path.empty()) saveShardState(job.state, out_path);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - job.started).count();
 
         std::cout << "\n--- BRUTE-FORCE VOLTOOID ---" << std::endl;
-        std::cout << "Top 10 beste transpositie-sleutels gevonden:\n" << std::endl;
-
-        for(int i = 0; i < std::min((size_t)10, all_results.size()); ++i) {
-            std::cout << " #" << i + 1 << ": Score = " << all_results[i].score << " | Sleutel: ";
-            for(int k : all_results[i].key) {
-                std::cout << k << " ";
-            }
-            std::cout << std::endl;
+        std::cout << "Iteraties: " << sa_iterations_done << " in " << seconds << " s ("
+                  << sa_iterations_done / std::max(seconds, 1e-9) << " it/s)" << std::endl;
+        if (job.budget_stopped) {
+            uint64_t done = std::count(job.state.done_blocks.begin(), job.state.done_blocks.end(), true);
+            std::cout << (stopRequested() ? "Gestopt op verzoek" : "Tijdsbudget op") << ": " << done << " van "
+                      << job.state.numBlocks() << " blokken afgewerkt; de ranking is onvolledig";
+            if (!out_path.empty()) std::cout << " (hervat met hetzelfde commando en --out " << out_path << ")";
+            std::cout << "." << std::endl;
         }
-
-        // Sla de top 10 op in het bestand
-        std::ofstream key_file("best_transpo_key.txt");
-        if (key_file.is_open()) {
-            for(int i = 0; i < std::min((size_t)10, all_results.size()); ++i) {
-                for (size_t j = 0; j < all_results[i].key.size(); ++j) {
-                    key_file << all_results[i].key[j] << (j == all_results[i].key.size() - 1 ? "" : " ");
-                }
-                key_file << std::endl;
+        if (results) {
+            submit_record(&job, !job.budget_stopped ? "finished" : stopRequested() ? "cancelled" : "timeout", seconds);
+            std::cout << "Resultaatrecord naar: " << results->jsonPath() << " en " << results->binaryPath() << std::endl;
+        }
+        if (cache_bits > 0) {
+            std::cout << describeScoreCache(cache_stats, ScoreCache::bytesFor(cache_bits) * threads_to_use) << std::endl;
+        }
+        if constexpr (ANNEAL_PROFILE) {
+            writeAnnealProfile(anneal_profile, "find_transposition", profile_path);
+            std::cout << "Profiel geschreven naar: " << profile_path << std::endl;
+        }
+        if (sharded) {
+            std::cout << "Shard " << shard.index << "/" << shard.count << " klaar; resultaten staan in " << out_path
+                      << ". Voeg alle shards samen met --merge." << std::endl;
+            for (size_t i = 0; i < std::min((size_t)10, job.state.top.ranked().size()); ++i) {
+                const auto& c = job.state.top.ranked()[i];
+                std::cout << " #" << i + 1 << ": Score = " << c.score << " | Sleutel: ";
+                for (int k : c.key) std::cout << k << " ";
+                std::cout << std::endl;
             }
-            key_file.close();
-            std::cout << "\nTop 10 beste sleutels zijn opgeslagen in best_transpo_key.txt" << std::endl;
-            std::cout << "De eerste (beste) sleutel in dit bestand zal worden gebruikt door solve_square." << std::endl;
+        } else {
+            report_top_keys(job.state.top.ranked());
         }
 
     } catch (const std::exception& e) {
@@ -10,36 +10,16 @@
 #include <numeric>
 #include <map>
 #include <iomanip>
+#include <chrono>
+#include <memory>
+#include <limits>
 
 #include "QuadgramScorer.h"
 #include "ADFGVX.h"
-
-std::string convertMorseToADFGVX(const std::string& morse_code) {
-    const std::map<std::string, char> morse_map = {
-        {".-",   'A'}, {"-..",  'D'}, {"..-.", 'F'},
-        {"--.",  'G'}, {"...-", 'V'}, {"-..-", 'X'}
-    };
-    std::string adfgvx_text;
-    std::string current_morse_char;
-    for (char c : morse_code) {
-        if (c == '.' || c == '-') {
-            current_morse_char += c;
-        } else if (c == '/') {
-            if (!current_morse_char.empty()) {
-                if (morse_map.count(current_morse_char)) {
-                    adfgvx_text += morse_map.at(current_morse_char);
-                }
-                current_morse_char.clear();
-            }
-        }
-    }
-    if (!current_morse_char.empty()) {
-        if (morse_map.count(current_morse_char)) {
-            adfgvx_text += morse_map.at(current_morse_char);
-        }
-    }
-    return adfgvx_text;
-}
+#include "Crib.h"
+#include "SquareAnneal.h"
+#include "../common/TimeBudget.h"
+#include "../common/ResultRecord.h"
 
 std::string loadFileContent(const std::string& filepath) {
     std::ifstream file(filepath);
@@ -51,92 +31,232 @@ std::string loadFileContent(const std::string& filepath) {
     return text;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
+        // Optioneel: --crib TEKST[@start[-eind]] (herhaalbaar) om cellen van het vierkant vast te pinnen.
+        // Andere invoer (o.a. bench/solve_bench): --in morsebestand, --transposition 4,0,6,2,1,3,5,
+        // --model naam, --iterations N, --seed N, --target-score S (stop zodra de beste score dit haalt).
+        // Met CODETHEORIE_PROFILE: --profile bestand (standaard anneal_profile.json).
+        // Anytime: --time-budget S loopt S seconden en rekt het schema van --iterations daarover uit
+        // (common/TimeBudget.h); SIGUSR1 toont de huidige beste, Ctrl-C stopt met het beste resultaat.
+        // Diepte: --in meermaals = berichten met dezelfde sleutels; samen gescoord, per bericht gerapporteerd.
+        // --results PREFIX [--results-top K]: gestructureerde record naar PREFIX.jsonl/.bin (common/ResultRecord.h).
+        std::vector<Crib> cribs;
         // Start vanuit de map adfgvx/ zodat basePath klopt.
         std::filesystem::path basePath = "../";
-        std::string ciphertext_path = (basePath / "adfgvx" / "03-OPGAVE-adfgvx.txt").string();
-        std::string quadgrams_path = (basePath / "data" / "spaceless_english_quadgrams.txt").string();
+        std::vector<std::string> ciphertext_paths;
+        std::string model_name = "spaceless_english";
+        std::vector<int> best_transpo_key = {4, 0, 6, 2, 1, 3, 5};
+        long long ITERATIONS_FOR_SQUARE_SEARCH = 10000000;
+        uint64_t seed = randomSeed();
+        bool has_target = false;
+        double target_score = 0.0;
+        std::string profile_path = "anneal_profile.json";
+        double time_budget = 0.0;
+        int cache_bits = 0;                   // --cache BITS: score-cache van 2^BITS sleutels (0 = uit)
+        std::string results_prefix;
+        size_t results_top = 10;
+        for (int a = 1; a < argc; ++a) {
+            std::string arg = argv[a];
+            if (arg == "--crib" && a + 1 < argc) {
+                cribs.push_back(parseCrib(argv[++a]));
+            } else if (arg == "--in" && a + 1 < argc) {
+                ciphertext_paths.push_back(argv[++a]);
+            } else if (arg == "--transposition" && a + 1 < argc) {
+                std::string order = argv[++a];
+                std::replace(order.begin(), order.end(), ',', ' ');
+                std::istringstream fields(order);
+                best_transpo_key.clear();
+                for (int k; fields >> k;) best_transpo_key.push_back(k);
+            } else if (arg == "--model" && a + 1 < argc) {
+                model_name = argv[++a];
+            } else if (arg == "--iterations" && a + 1 < argc) {
+                ITERATIONS_FOR_SQUARE_SEARCH = std::stoll(argv[++a]);
+            } else if (arg == "--cache" && a + 1 < argc) {
+                cache_bits = std::stoi(argv[++a]);
+            } else if (arg == "--time-budget" && a + 1 < argc) {
+                time_budget = std::stod(argv[++a]);
+            } else if (arg == "--seed" && a + 1 < argc) {
+                seed = std::stoull(argv[++a]);
+            } else if (arg == "--results" && a + 1 < argc) {
+                results_prefix = argv[++a];
+            } else if (arg == "--results-top" && a + 1 < argc) {
+                results_top = std::stoul(argv[++a]);
+            } else if (arg == "--profile" && a + 1 < argc) {
+                profile_path = argv[++a];
+                if (!ANNEAL_PROFILE) std::cerr << "Let op: --profile werkt enkel als gecompileerd met CODETHEORIE_PROFILE." << std::endl;
+            } else if (arg == "--target-score" && a + 1 < argc) {
+                target_score = std::stod(argv[++a]);
+                has_target = true;
+            } else {
+                throw std::invalid_argument("Onbekend argument: " + arg + " (gebruik: [--crib TEKST[@start[-eind]]]"
+                    " [--in bestand]... [--transposition k,k,...] [--model naam] [--iterations N] [--time-budget S] [--seed N] [--cache BITS] [--target-score S] [--results prefix [--results-top K]] [--profile bestand])");
+            }
+        }
+        std::string quadgrams_path = (basePath / "data" / (model_name + "_quadgrams.txt")).string();
 
         QuadgramScorer scorer(quadgrams_path);
-        std::string morse_ciphertext = loadFileContent(ciphertext_path);
-        std::string ciphertext = convertMorseToADFGVX(morse_ciphertext);
-        if (ciphertext.length() % 2 != 0) { ciphertext.pop_back(); }
-        std::cout << "Ciphertext geladen (" << ciphertext.length() << " tekens).\n" << std::endl;
+        std::unique_ptr<ResultWriter> results;
+        if (!results_prefix.empty()) results = std::make_unique<ResultWriter>(results_prefix);
+        if (ciphertext_paths.empty()) ciphertext_paths.push_back((basePath / "adfgvx" / "03-OPGAVE-adfgvx.txt").string());
+        std::vector<std::string> ciphertexts;
+        for (const std::string& ciphertext_path : ciphertext_paths) {
+            std::string ciphertext = morseToADFGVX(loadFileContent(ciphertext_path));
+            if (ciphertext.length() % 2 != 0) { ciphertext.pop_back(); }
+            std::cout << "Ciphertext geladen uit " << ciphertext_path << " (" << ciphertext.length() << " tekens)." << std::endl;
+            ciphertexts.push_back(ciphertext);
+        }
+        std::cout << std::endl;
 
         ADFGVX cipher;
-        std::mt19937 rng(std::random_device{}());
+        Rng rng(seed);
         std::cout << std::fixed << std::setprecision(2);
+        std::cout << "Seed " << seed << " (--seed " << seed << " herhaalt deze run)." << std::endl;
 
         std::cout << "--- FASE 2: Starten van definitieve aanval op het Polybius-vierkant ---\n" << std::endl;
 
-        std::vector<int> best_transpo_key = {4, 0, 6, 2, 1, 3, 5};
-
         std::cout << "Gebruiken van bewezen transpositie-sleutel: ";
         for(int k : best_transpo_key) std::cout << k << " ";
         std::cout << std::endl;
 
-        const int ITERATIONS_FOR_SQUARE_SEARCH = 10000000;
-
-        std::string parent_square_key = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
-        std::shuffle(parent_square_key.begin(), parent_square_key.end(), rng);
-
-        cipher.setKeys(parent_square_key, best_transpo_key);
-        double parent_score = scorer.score_strict(cipher.decrypt(ciphertext));
-
-        double overall_best_score = -999999.0;
-        std::string best_square_key = "";
-        std::string best_plaintext = "";
-
-        double temperature = 100.0;
-        double cooling_rate = 0.999995;
-
-        for (long long i = 0; i < ITERATIONS_FOR_SQUARE_SEARCH; ++i) {
-             if (i > 0 && i % 50000 == 0) {
-                std::cout << "Iter: " << i / 1000 << "k | Huidige: " << parent_score << " | Beste: " << overall_best_score << " | Temp: " << temperature << std::endl;
+        CribPins pins;
+        if (!cribs.empty()) {
+            std::vector<size_t> message_ends;
+            std::string stream = undoTranspositions(ciphertexts, best_transpo_key, message_ends);
+            if (!findCribPins(stream, cribs, pins, message_ends)) {
+                throw std::runtime_error("De cribs zijn niet consistent met deze transpositie-sleutel.");
             }
+            std::cout << "Cribs pinnen " << pins.pinnedCount() << " van de 36 cellen vast." << std::endl;
+        }
+        // Mutaties werken enkel op de vrije cellen (zonder cribs: alle 36); instellingen in SquareAnneal.h.
+        SquareAnnealer<true> annealer = makeSquareAnnealer(scorer, freeCells(pins));
+        annealer.enableScoreCache(cache_bits);
+        annealer.scorer().setTransposition(ciphertexts, best_transpo_key);
+        if (!annealer.scorer().valid()) {
+            throw std::runtime_error("Een ciphertext geeft geen geldige digrafen onder deze transpositie-sleutel.");
+        }
+        // Alles vast door de cribs: er valt niets meer te zoeken.
+        if (!annealer.mutator().canMove()) ITERATIONS_FOR_SQUARE_SEARCH = 0;
 
-            std::string child_square_key = parent_square_key;
-            std::uniform_int_distribution<int> mutation_choice(0, 100);
-            int choice = mutation_choice(rng);
+        std::unique_ptr<TimeBudget> budget;
+        long long iteration_limit = ITERATIONS_FOR_SQUARE_SEARCH;
+        if (time_budget > 0.0 && ITERATIONS_FOR_SQUARE_SEARCH > 0) {
+            budget = std::make_unique<TimeBudget>(time_budget, annealer.schedule(), ITERATIONS_FOR_SQUARE_SEARCH);
+            iteration_limit = std::numeric_limits<long long>::max();
+            installAnytimeSignals();
+            std::cout << "Tijdsbudget " << time_budget << " s: het schema van " << ITERATIONS_FOR_SQUARE_SEARCH
+                      << " iteraties wordt over het budget uitgerekt (eindtemperatuur " << std::scientific << budget->finalTemperature() << std::fixed << ")." << std::endl;
+        }
 
-            if (choice < 60) {
-                 int pos_a = std::uniform_int_distribution<int>(0, 35)(rng);
-                 int pos_b = std::uniform_int_distribution<int>(0, 35)(rng);
-                 std::swap(child_square_key[pos_a], child_square_key[pos_b]);
-            } else {
-                int start = std::uniform_int_distribution<int>(0, 35)(rng);
-                int end = std::uniform_int_distribution<int>(0, 35)(rng);
-                if (start > end) std::swap(start, end);
-                std::reverse(child_square_key.begin() + start, child_square_key.begin() + end);
-            }
+        struct Progress : AnnealObserver {
+            ADFGVX& cipher;
+            const std::vector<std::string>& ciphertexts;  // de voorbeeldtekst komt uit het eerste bericht
+            const std::vector<int>& transposition;
+            bool has_target;
+            double target_score;
+            TimeBudget* budget;                           // nullptr = vaste iteraties
+            GeometricSchedule& schedule;
+            std::string best_key;
+            ResultCandidates& candidates;
 
-            cipher.setKeys(child_square_key, best_transpo_key);
-            std::string child_plain = cipher.decrypt(ciphertext);
-            if (child_plain.empty()) continue;
+            Progress(ADFGVX& cipher, const std::vector<std::string>& ciphertexts, const std::vector<int>& transposition,
+                     bool has_target, double target_score, TimeBudget* budget, GeometricSchedule& schedule,
+                     ResultCandidates& candidates)
+                : cipher(cipher), ciphertexts(ciphertexts), transposition(transposition),
+                  has_target(has_target), target_score(target_score), budget(budget), schedule(schedule),
+                  candidates(candidates) {}
 
-            double child_score = scorer.score_strict(child_plain);
-            if (child_score > parent_score || exp((child_score - parent_score) / temperature) > std::uniform_real_distribution<>(0.0, 1.0)(rng)) {
-                parent_score = child_score; parent_square_key = child_square_key;
+            bool onBest(long long, const std::string& square_key, double score, double) {
+                best_key = square_key;
+                candidates.add(score, square_key);
+                cipher.setKeys(square_key, transposition);
+                std::cout << "\n>>> NIEUW RECORD <<<" << " Score: " << score << std::endl;
+                std::cout << "    Tekst: " << cipher.decrypt(ciphertexts.front()).substr(0, 120) << "...\n" << std::endl;
+                return !(has_target && score >= target_score);
             }
-
-            if (parent_score > overall_best_score) {
-                overall_best_score = parent_score;
-                best_square_key = parent_square_key;
-                best_plaintext = cipher.decrypt(ciphertext);
-                std::cout << "\n>>> NIEUW RECORD <<<" << " Score: " << overall_best_score << std::endl;
-                std::cout << "    Tekst: " << best_plaintext.substr(0, 120) << "...\n" << std::endl;
+            bool onIteration(long long i, double current, double best, double temperature) {
+                if (i > 0 && i % 50000 == 0) {
+                    std::cout << "Iter: " << i / 1000 << "k | Huidige: " << current << " | Beste: " << best << " | Temp: " << temperature << std::endl;
+                }
+                if (!budget) return true;
+                if (takePublishRequest() && !best_key.empty()) {
+                    cipher.setKeys(best_key, transposition);
+                    std::cout << "--- Tussenstand na " << budget->elapsed() << " s, iteratie " << i << " (Temp: " << temperature
+                              << ", " << budget->iterationsPerSecond() << " it/s) ---" << std::endl;
+                    std::cout << "Beste score: " << best << "\nPolybius sleutel: " << best_key << std::endl;
+                    for (const std::string& ciphertext : ciphertexts) std::cout << "Tekst: " << cipher.decrypt(ciphertext) << std::endl;
+                    std::cout << std::endl;
+                }
+                return budget->check(i, schedule);
             }
+        };
 
-            temperature *= cooling_rate;
-        }
+        std::string square_key = randomPinnedSquare(pins, rng);
+        auto started = std::chrono::steady_clock::now();
+        ResultCandidates candidates(results_top);
+        auto result = annealer.run(square_key, rng, iteration_limit,
+                                   Progress(cipher, ciphertexts, best_transpo_key, has_target, target_score, budget.get(),
+                                            annealer.schedule(), candidates));
+        long long iterations_done = result.iterations;
+        double overall_best_score = result.best_score;
+        std::string best_square_key = result.best;
+        cipher.setKeys(best_square_key, best_transpo_key);
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
 
         std::cout << "\n\n--- Aanval voltooid ---" << std::endl;
+        std::cout << "Iteraties: " << iterations_done << " in " << seconds << " s ("
+                  << iterations_done / std::max(seconds, 1e-9) << " it/s)" << std::endl;
+        if (budget && (stopRequested() || budget->elapsed() >= time_budget)) {
+            std::cout << (stopRequested() ? "Gestopt op verzoek" : "Tijdsbudget op") << " na " << seconds << " van "
+                      << time_budget << " s (eindtemperatuur " << std::scientific << annealer.schedule().temperature() << std::fixed << ")." << std::endl;
+        }
         std::cout << "Beste score: " << overall_best_score << std::endl;
         std::cout << "Beste Polybius sleutel: " << best_square_key << std::endl;
+        if (cache_bits > 0) std::cout << describeScoreCache(annealer.cacheStats(), annealer.cacheBytes()) << std::endl;
+        if constexpr (ANNEAL_PROFILE) {
+            writeAnnealProfile(annealer.profile(), "solve_square", profile_path);
+            std::cout << "Profiel geschreven naar: " << profile_path << std::endl;
+        }
         std::cout << "Beste transpositievolgorde: ";
         for (int i : best_transpo_key) std::cout << i << " ";
-        std::cout << "\n\nOntsleutelde tekst:\n" << best_plaintext << std::endl;
+        std::cout << std::endl;
+        // Per bericht de ontsleutelde tekst, met zijn eigen (strikte) score.
+        for (size_t m = 0; m < ciphertexts.size(); ++m) {
+            SquareScorer<true> message_scorer(scorer);
+            message_scorer.setTransposition(ciphertexts[m], best_transpo_key);
+            message_scorer.decode(best_square_key);
+            if (ciphertexts.size() > 1) {
+                std::cout << "\nBericht " << m + 1 << " (" << ciphertext_paths[m] << ", score " << message_scorer.score() << "):";
+            } else {
+                std::cout << "\nOntsleutelde tekst:";
+            }
+            std::cout << "\n" << cipher.decrypt(ciphertexts[m]) << std::endl;
+        }
+
+        // Bij meerdere berichten staan hun plaintexts in één veld, gescheiden door een regeleinde.
+        if (results) {
+            ResultRecord record;
+            record.solver = "solve_square_adfgvx";
+            record.status = has_target && overall_best_score >= target_score ? "solved"
+                          : stopRequested() ? "cancelled"
+                          : budget && budget->elapsed() >= time_budget ? "timeout" : "finished";
+            record.model = model_name;
+            for (size_t m = 0; m < ciphertext_paths.size(); ++m) record.input += (m ? "," : "") + ciphertext_paths[m];
+            record.seed = seed;
+            record.iterations = iterations_done;
+            record.seconds = seconds;
+            record.addInfo("transposition", keyText(best_transpo_key));
+            if (!cribs.empty()) record.addInfo("pinned_cells", pins.pinnedCount());
+            record.top = candidates.ranked();
+            if (record.top.empty()) record.top.push_back({overall_best_score, best_square_key, ""});
+            for (ResultCandidate& candidate : record.top) {
+                cipher.setKeys(candidate.key, best_transpo_key);
+                for (size_t m = 0; m < ciphertexts.size(); ++m) candidate.plaintext += (m ? "\n" : "") + cipher.decrypt(ciphertexts[m]);
+            }
+            results->submit(std::move(record));
+            std::cout << "\nResultaatrecord naar: " << results->jsonPath() << " en " << results->binaryPath() << std::endl;
+        }
 
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
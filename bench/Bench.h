@@ -0,0 +1,99 @@
+#ifndef BENCH_BENCH_H
+#define BENCH_BENCH_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+// Kleine meetbibliotheek voor de benchmarks in bench/: opwarmen, herhalen, percentielen,
+// en een baselinebestand om regressies te vinden.
+
+// q in [0, 1] op een gesorteerde reeks (dichtstbijzijnde rang).
+inline double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(std::lround(q * (sorted.size() - 1)));
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+struct BenchSettings {
+    double warmup_ms = 100.0;   // opwarmen en tegelijk de batchgrootte schatten
+    double sample_ms = 10.0;    // duur van één meting (een batch oproepen)
+    int samples = 30;
+};
+
+struct KernelResult {
+    std::string name;
+    double items_per_op = 0;    // bv. letters per oproep
+    uint64_t ops_per_sample = 0;
+    std::vector<double> ns_per_op;   // per meting, gesorteerd
+
+    double median() const { return percentile(ns_per_op, 0.5); }
+    double itemsPerSecond() const { return median() > 0 ? items_per_op * 1e9 / median() : 0.0; }
+};
+
+// Voert op() herhaald uit. op() geeft een getal terug dat in een checksum belandt, zodat de
+// compiler het werk niet kan wegoptimaliseren.
+template <typename Op>
+KernelResult measureKernel(const std::string& name, double items_per_op, Op op,
+                           const BenchSettings& settings, double& checksum) {
+    using clock = std::chrono::steady_clock;
+    KernelResult result;
+    result.name = name;
+    result.items_per_op = items_per_op;
+
+    // Opwarmen (caches, branch predictors, CPU-frequentie) en meteen tellen hoeveel oproepen
+    // er in de opwarmtijd passen.
+    uint64_t warm_ops = 0;
+    auto start = clock::now();
+    double warm_ns = 0;
+    do {
+        checksum += op();
+        warm_ops++;
+        warm_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+    } while (warm_ns < settings.warmup_ms * 1e6);
+
+    double estimate = warm_ns / warm_ops;
+    result.ops_per_sample = std::max<uint64_t>(1, static_cast<uint64_t>(settings.sample_ms * 1e6 / estimate));
+
+    for (int s = 0; s < settings.samples; ++s) {
+        auto t0 = clock::now();
+        for (uint64_t i = 0; i < result.ops_per_sample; ++i) checksum += op();
+        double ns = std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+        result.ns_per_op.push_back(ns / result.ops_per_sample);
+    }
+    std::sort(result.ns_per_op.begin(), result.ns_per_op.end());
+    return result;
+}
+
+// Baseline: per regel "<naam> <mediaan ns/op>"; regels met # zijn commentaar.
+inline std::map<std::string, double> readBaseline(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Kon baseline niet openen: " + path);
+    std::map<std::string, double> baseline;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        std::string name;
+        double ns;
+        if (fields >> name >> ns) baseline[name] = ns;
+    }
+    return baseline;
+}
+
+inline void writeBaseline(const std::string& path, const std::vector<KernelResult>& results) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Kon baseline niet schrijven: " + path);
+    out << "# kernel mediaan_ns_per_op\n";
+    out.precision(6);
+    for (const auto& r : results) out << r.name << " " << std::fixed << r.median() << "\n";
+}
+
+#endif // BENCH_BENCH_H
@@ -0,0 +1,142 @@
+#ifndef BENCH_WORKLOAD_H
+#define BENCH_WORKLOAD_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <stdexcept>
+
+#include "playfair/Playfair.h"
+#include "adfgvx/ADFGVX.h"
+#include "viginereplus/Vigenere.h"
+
+// Synthetische testberichten: plaintext uit data/corpus.txt, sleutels getrokken uit een seed.
+// Dezelfde (cipher, lengte, breedte, seed) geeft altijd hetzelfde bericht.
+
+struct Workload {
+    std::string cipher;              // "playfair", "adfgvx" of "vigenereplus"
+    int length = 0;                  // letters plaintext (Playfair: voor de X-opvulling)
+    int width = 0;                   // transpositiebreedte (niet voor Playfair)
+    uint64_t seed = 0;
+    std::string plaintext;           // zoals de solver hem moet teruggeven
+    std::string ciphertext;          // zoals de solver hem inleest (ADFGVX: morse)
+    std::string key;                 // Playfair-rooster, Polybius-vierkant of Vigenère-sleutel
+    std::vector<int> transposition;  // in de conventie van de solver
+};
+
+// ADFGVX-letters naar de morse-notatie van de opgave ("/" tussen de tekens).
+inline std::string adfgvxToMorse(const std::string& text) {
+    std::string morse;
+    for (char c : text) {
+        if (!morse.empty()) morse += '/';
+        switch (c) {
+            case 'A': morse += ".-"; break;
+            case 'D': morse += "-.."; break;
+            case 'F': morse += "..-."; break;
+            case 'G': morse += "--."; break;
+            case 'V': morse += "...-"; break;
+            case 'X': morse += "-..-"; break;
+            default: throw std::invalid_argument(std::string("Geen ADFGVX-teken: ") + c);
+        }
+    }
+    return morse;
+}
+
+class WorkloadGenerator {
+public:
+    explicit WorkloadGenerator(const std::string& corpus_path) {
+        std::ifstream in(corpus_path);
+        if (!in) throw std::runtime_error("Kon corpus niet openen: " + corpus_path);
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        for (char c : buffer.str()) {
+            if (std::isalpha(static_cast<unsigned char>(c))) {
+                corpus += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            }
+        }
+        if (corpus.empty()) throw std::runtime_error("Corpus bevat geen letters: " + corpus_path);
+    }
+
+    // key_length geldt enkel voor Vigenère-plus.
+    Workload make(const std::string& cipher, int length, int width, uint64_t seed, int key_length = 7) const {
+        std::mt19937_64 rng(seed);
+        Workload w;
+        w.cipher = cipher;
+        w.length = length;
+        w.width = width;
+        w.seed = seed;
+        std::string sample = sampleCorpus(length, rng);
+
+        if (cipher == "playfair") {
+            w.width = 0;
+            w.key = "ABCDEFGHIKLMNOPQRSTUVWXYZ";
+            std::shuffle(w.key.begin(), w.key.end(), rng);
+        } else if (cipher == "adfgvx") {
+            w.key = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+            std::shuffle(w.key.begin(), w.key.end(), rng);
+            w.transposition = randomPermutation(width, rng);
+        } else if (cipher == "vigenereplus") {
+            for (int i = 0; i < key_length; ++i) w.key += static_cast<char>('A' + rng() % 26);
+            w.transposition = randomPermutation(width, rng);
+        } else {
+            throw std::invalid_argument("Onbekend cijfer: " + cipher + " (playfair, adfgvx of vigenereplus)");
+        }
+        encrypt(w, sample);
+        return w;
+    }
+
+    // Nog een bericht met dezelfde sleutels als 'base' (diepte), met een andere plaintext en lengte.
+    Workload makeWithKeys(const Workload& base, int length, uint64_t seed) const {
+        std::mt19937_64 rng(seed);
+        Workload w = base;
+        w.length = length;
+        w.seed = seed;
+        encrypt(w, sampleCorpus(length, rng));
+        return w;
+    }
+
+private:
+    std::string sampleCorpus(int length, std::mt19937_64& rng) const {
+        if (length < 4 || static_cast<size_t>(length) > corpus.size()) {
+            throw std::invalid_argument("Ongeldige berichtlengte: " + std::to_string(length));
+        }
+        size_t offset = std::uniform_int_distribution<size_t>(0, corpus.size() - length)(rng);
+        return corpus.substr(offset, length);
+    }
+
+    // Vult plaintext en ciphertext van w met de sleutels die er al in staan.
+    static void encrypt(Workload& w, const std::string& sample) {
+        if (w.cipher == "playfair") {
+            Playfair playfair;
+            playfair.setKey(w.key);
+            w.plaintext = Playfair::preparePlaintext(sample);
+            w.ciphertext = playfair.encrypt(w.plaintext);
+        } else if (w.cipher == "adfgvx") {
+            ADFGVX adfgvx;
+            adfgvx.setKeys(w.key, w.transposition);
+            w.plaintext = sample;
+            w.ciphertext = adfgvxToMorse(adfgvx.encrypt(sample));
+        } else {
+            w.plaintext = sample;
+            w.ciphertext = encrypt_vigenereplus(sample, w.transposition, w.key);
+        }
+    }
+
+    static std::vector<int> randomPermutation(int width, std::mt19937_64& rng) {
+        if (width < 2) throw std::invalid_argument("Transpositiebreedte moet minstens 2 zijn.");
+        std::vector<int> perm(width);
+        std::iota(perm.begin(), perm.end(), 0);
+        std::shuffle(perm.begin(), perm.end(), rng);
+        return perm;
+    }
+
+    std::string corpus;
+};
+
+#endif // BENCH_WORKLOAD_H
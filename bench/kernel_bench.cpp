@@ -0,0 +1,236 @@
+// Microbenchmarks van de hete kernels van de drie solvers.
+//
+//   cmake -S . -B build && cmake --build build -j && ./build/kernel_bench
+//   ./build/kernel_bench --save-baseline bench/baseline.txt
+//   ./build/kernel_bench --baseline bench/baseline.txt --threshold 10   # exit 1 bij regressie
+//
+// Per kernel: opwarmen, dan --samples metingen van elk ~--sample-ms. Gerapporteerd worden de
+// mediaan (ns/op), p90/p99 over de metingen en items/s (letters of tekens per seconde).
+// Invoer: de opgaves en data/ uit de bronmap (of --root).
+// --huge-pages off|thp|explicit en --numa-replicate plaatsen de quadgramtabel zoals in de solvers
+// (common/TablePlacement.h); quadgram_random_letters meet dan willekeurige opzoekingen per seconde.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <iomanip>
+#include <filesystem>
+
+#include "bench/Bench.h"
+#include "common/QuadgramScorer.h"
+#include "common/PeriodicHistogram.h"
+#include "playfair/Playfair.h"
+#include "adfgvx/ADFGVX.h"
+#include "viginereplus/Vigenere.h"
+
+#ifndef CODETHEORIE_SOURCE_DIR
+#define CODETHEORIE_SOURCE_DIR "."
+#endif
+
+using namespace std;
+
+string read_file(const filesystem::path& path) {
+    ifstream in(path);
+    if (!in) throw runtime_error("Kon bestand niet openen: " + path.string());
+    stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+string letters_only(const string& text) {
+    string out;
+    for (char c : text) {
+        if (isalpha(static_cast<unsigned char>(c))) out += static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    }
+    return out;
+}
+
+struct Kernel {
+    string name;
+    double items;
+    function<double()> op;
+};
+
+int main(int argc, char* argv[]) {
+    filesystem::path root = CODETHEORIE_SOURCE_DIR;
+    BenchSettings settings;
+    string filter;
+    string save_path;
+    string baseline_path;
+    double threshold = 10.0;   // procent
+    TablePlacement placement;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("Ontbrekende waarde voor " + arg);
+            return argv[++i];
+        };
+        try {
+            if (arg == "--root") root = value();
+            else if (arg == "--filter") filter = value();
+            else if (arg == "--samples") settings.samples = max(1, stoi(value()));
+            else if (arg == "--sample-ms") settings.sample_ms = stod(value());
+            else if (arg == "--warmup-ms") settings.warmup_ms = stod(value());
+            else if (arg == "--save-baseline") save_path = value();
+            else if (arg == "--baseline") baseline_path = value();
+            else if (arg == "--threshold") threshold = stod(value());
+            else if (arg == "--huge-pages") placement.huge_pages = parseHugePages(value());
+            else if (arg == "--numa-replicate") placement.numa_replicate = true;
+            else {
+                cerr << "Onbekende optie: " << arg << endl;
+                return 1;
+            }
+        } catch (const exception& ex) {
+            cerr << "Ongeldige waarde voor " << arg << ": " << ex.what() << endl;
+            return 1;
+        }
+    }
+
+    // --- Invoer ---
+    string english;
+    string playfair_cipher;
+    string vigenere_cipher;
+    unique_ptr<QuadgramScorer> scorer;
+    try {
+        english = letters_only(read_file(root / "data" / "corpus.txt")).substr(100000, 1000);
+        scorer = make_unique<QuadgramScorer>((root / "data" / "english_quadgrams.txt").string());
+        scorer->placeTable(placement);
+
+        playfair_cipher = letters_only(read_file(root / "playfair" / "02-OPGAVE-playfair.txt"));
+        replace(playfair_cipher.begin(), playfair_cipher.end(), 'J', 'I');
+        if (playfair_cipher.size() % 2 != 0) playfair_cipher.pop_back();
+
+        vigenere_cipher = letters_only(read_file(root / "viginereplus" / "01-OPGAVE-viginereplus.txt"));
+    } catch (const exception& ex) {
+        cerr << ex.what() << " (gebruik --root <repo>)" << endl;
+        return 1;
+    }
+
+    // ADFGVX-tekst zoals find_transposition/solve_square hem zien: letters en cijfers.
+    string mixed = english;
+    for (size_t i = 7; i < mixed.size(); i += 13) mixed[i] = static_cast<char>('0' + i % 10);
+
+    vector<uint8_t> english_letters;
+    for (char c : english) english_letters.push_back(static_cast<uint8_t>(c - 'A'));
+
+    Playfair playfair;
+    playfair.setKey("YTVWXIGABRQELCMHUZDFSKNOP");
+    vector<uint8_t> playfair_letters;
+    for (char c : playfair_cipher) playfair_letters.push_back(static_cast<uint8_t>(c - 'A'));
+    vector<uint8_t> playfair_plain(playfair_letters.size());
+    vector<uint8_t> mixed_symbols = QuadgramScorer::symbolIndices(mixed);
+
+    mt19937 rng(1);
+    // Willekeurige letters: elke quadgram is een opzoeking op een willekeurige plaats in de tabel
+    // (echte tekst blijft in een klein, heet deel), dus dit meet TLB- en cachemissers.
+    vector<uint8_t> random_letters(4096);
+    for (uint8_t& letter : random_letters) letter = static_cast<uint8_t>(rng() % 26);
+    string adfgvx_cipher(2000, 'A');
+    for (char& c : adfgvx_cipher) c = "ADFGVX"[rng() % 6];
+    const vector<int> adfgvx_order = {4, 0, 6, 2, 1, 3, 5};
+    ADFGVX adfgvx;
+    adfgvx.setKeys("ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789", adfgvx_order);
+
+    const vector<int> vigenere_order = {3, 0, 2, 4, 1, 5};
+    string vigenere_text = decrypt_columnar(vigenere_cipher, vigenere_order);
+
+    // calculate_ic bestaat niet meer: de IC van alle periodes komt uit periodicHistograms.
+    vector<Kernel> kernels = {
+        {"quadgram_score", double(english.size()), [&] { return scorer->score(english); }},
+        {"quadgram_score_tolerant", double(mixed.size()), [&] { return scorer->score_tolerant(mixed); }},
+        {"quadgram_score_strict", double(mixed.size()), [&] { return scorer->score_strict(mixed); }},
+        {"quadgram_score_letters", double(english_letters.size()),
+         [&] { return scorer->scoreLetters(english_letters.data(), english_letters.size()); }},
+        {"quadgram_symbols_strict", double(mixed_symbols.size()),
+         [&] { return scorer->scoreSymbolsStrict(mixed_symbols.data(), mixed_symbols.size()); }},
+        {"quadgram_random_letters", double(random_letters.size()),
+         [&] { return scorer->scoreLetters(random_letters.data(), random_letters.size()); }},
+        {"playfair_decrypt", double(playfair_cipher.size()),
+         [&] { return double(playfair.decrypt(playfair_cipher)[0]); }},
+        {"playfair_decrypt_letters", double(playfair_letters.size()), [&] {
+             Playfair::decryptLetters("YTVWXIGABRQELCMHUZDFSKNOP", playfair_letters.data(), playfair_letters.size(),
+                                      playfair_plain.data());
+             return double(playfair_plain[0]);
+         }},
+        {"adfgvx_undo_transposition", double(adfgvx_cipher.size()),
+         [&] { return double(ADFGVX::undoColumnarTransposition(adfgvx_cipher, adfgvx_order)[0]); }},
+        {"adfgvx_decrypt", double(adfgvx_cipher.size()), [&] { return double(adfgvx.decrypt(adfgvx_cipher)[0]); }},
+        {"decrypt_columnar", double(vigenere_cipher.size()),
+         [&] { return double(decrypt_columnar(vigenere_cipher, vigenere_order)[0]); }},
+        {"periodic_ic", double(vigenere_text.size()), [&] {
+             PeriodicHistograms hist;
+             periodicHistograms(vigenere_text, hist);
+             double avg_ic[PeriodicHistograms::MAX_PERIOD + 1];
+             periodICs(hist, avg_ic);
+             return avg_ic[PeriodicHistograms::MAX_PERIOD];
+         }},
+        {"crack_vigenere", double(vigenere_text.size()),
+         [&] { return double(crack_vigenere(vigenere_text).key.size()); }},
+    };
+
+    map<string, double> baseline;
+    if (!baseline_path.empty()) {
+        try {
+            baseline = readBaseline(baseline_path);
+        } catch (const exception& ex) {
+            cerr << ex.what() << endl;
+            return 1;
+        }
+    }
+
+    cout << "Kernel-benchmark: " << settings.samples << " metingen van ~" << settings.sample_ms
+         << " ms na " << settings.warmup_ms << " ms opwarmen (IC-kernel " << histogramKernelName(bestHistogramKernel()) << ")" << endl;
+    cout << "Quadgramtabel: " << scorer->describeTablePlacement() << endl;
+    cout << left << setw(28) << "kernel" << right << setw(12) << "ns/op" << setw(12) << "p90" << setw(12) << "p99"
+         << setw(14) << "items/s" << (baseline.empty() ? "" : "    t.o.v. baseline") << endl;
+
+    vector<KernelResult> results;
+    int regressions = 0;
+    double checksum = 0;
+    for (const auto& k : kernels) {
+        if (!filter.empty() && k.name.find(filter) == string::npos) continue;
+        KernelResult r = measureKernel(k.name, k.items, k.op, settings, checksum);
+        results.push_back(r);
+
+        cout << left << setw(28) << r.name << right << fixed << setprecision(1)
+             << setw(12) << r.median() << setw(12) << percentile(r.ns_per_op, 0.9)
+             << setw(12) << percentile(r.ns_per_op, 0.99) << setw(14) << setprecision(3) << scientific
+             << r.itemsPerSecond() << fixed;
+        if (!baseline.empty()) {
+            auto it = baseline.find(r.name);
+            if (it == baseline.end()) {
+                cout << "    (nieuw)";
+            } else {
+                double change = 100.0 * (r.median() / it->second - 1.0);
+                cout << "    " << showpos << setprecision(1) << change << "%" << noshowpos;
+                if (change > threshold) {
+                    cout << "  REGRESSIE";
+                    regressions++;
+                }
+            }
+        }
+        cout << endl;
+    }
+    cerr << "checksum " << checksum << endl;
+
+    if (!save_path.empty()) {
+        try {
+            writeBaseline(save_path, results);
+            cout << "Baseline opgeslagen in " << save_path << endl;
+        } catch (const exception& ex) {
+            cerr << ex.what() << endl;
+            return 1;
+        }
+    }
+    if (regressions > 0) {
+        cout << regressions << " kernel(s) meer dan " << threshold << "% trager dan de baseline." << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+// Schrijft één synthetisch testbericht weg: ciphertext in het invoerformaat van de solver
+// plus de grondwaarheid (sleutels en plaintext).
+//
+//   ./build/make_workload --cipher adfgvx --length 600 --width 5 --seed 7 --out /tmp/adfgvx_7
+//   -> /tmp/adfgvx_7.cipher.txt en /tmp/adfgvx_7.truth.txt
+//
+// Met --depth N: N berichten met dezelfde sleutels (diepte), PREFIX.1.* tot PREFIX.N.*.
+// Bericht m (vanaf 1) is 7*(m-1) letters korter dan --length, zodat de kolomindeling verschilt.
+
+#include <iostream>
+#include <string>
+#include <fstream>
+#include <filesystem>
+
+#include "bench/Workload.h"
+
+#ifndef CODETHEORIE_SOURCE_DIR
+#define CODETHEORIE_SOURCE_DIR "."
+#endif
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    filesystem::path root = CODETHEORIE_SOURCE_DIR;
+    string cipher;
+    int length = 1000;
+    int width = 0;
+    int key_length = 7;
+    int depth = 1;
+    uint64_t seed = 1;
+    string out_prefix;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("Ontbrekende waarde voor " + arg);
+            return argv[++i];
+        };
+        try {
+            if (arg == "--root") root = value();
+            else if (arg == "--cipher") cipher = value();
+            else if (arg == "--length") length = stoi(value());
+            else if (arg == "--width") width = stoi(value());
+            else if (arg == "--key-len") key_length = stoi(value());
+            else if (arg == "--seed") seed = stoull(value());
+            else if (arg == "--depth") depth = stoi(value());
+            else if (arg == "--out") out_prefix = value();
+            else {
+                cerr << "Onbekende optie: " << arg << endl;
+                return 1;
+            }
+        } catch (const exception& ex) {
+            cerr << "Ongeldige waarde voor " << arg << ": " << ex.what() << endl;
+            return 1;
+        }
+    }
+    if (cipher.empty() || out_prefix.empty()) {
+        cerr << "Gebruik: make_workload --cipher playfair|adfgvx|vigenereplus [--length N] [--width W] "
+                "[--key-len L] [--seed S] [--depth N] --out PREFIX" << endl;
+        return 1;
+    }
+    if (width == 0) width = cipher == "vigenereplus" ? 6 : 7;
+
+    try {
+        WorkloadGenerator generator((root / "data" / "corpus.txt").string());
+        Workload first = generator.make(cipher, length, width, seed, key_length);
+        for (int m = 1; m <= max(1, depth); ++m) {
+            Workload w = m == 1 ? first : generator.makeWithKeys(first, length - 7 * (m - 1), seed + m - 1);
+            string prefix = depth > 1 ? out_prefix + "." + to_string(m) : out_prefix;
+
+            ofstream cipher_file(prefix + ".cipher.txt");
+            ofstream truth_file(prefix + ".truth.txt");
+            if (!cipher_file || !truth_file) throw runtime_error("Kon uitvoer niet schrijven naar " + prefix + ".*");
+            cipher_file << w.ciphertext << "\n";
+
+            truth_file << "cipher " << w.cipher << "\n";
+            truth_file << "seed " << w.seed << "\n";
+            truth_file << "length " << w.length << "\n";
+            if (!w.transposition.empty()) {
+                truth_file << "transposition";
+                for (int k : w.transposition) truth_file << " " << k;
+                truth_file << "\n";
+            }
+            truth_file << "key " << w.key << "\n";
+            truth_file << "plaintext " << w.plaintext << "\n";
+            cout << "Geschreven: " << prefix << ".cipher.txt en " << prefix << ".truth.txt" << endl;
+        }
+    } catch (const exception& ex) {
+        cerr << ex.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,167 @@
+// Zet binaire resultaatrecords (--results PREFIX van de solvers, PREFIX.bin) om naar JSON lines,
+// in hetzelfde formaat als PREFIX.jsonl (common/ResultRecord.h).
+//
+//   ./build/result_dump runs.bin                 # alle records, alle kandidaten
+//   ./build/result_dump --top 3 a.bin b.bin      # enkel de 3 beste kandidaten per record
+//   ./build/result_dump --selftest               # encode/decode-roundtrip en afgekapte records (ctest)
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+#include "common/ResultRecord.h"
+#include "common/JsonLine.h"
+
+using namespace std;
+
+int selftest() {
+    int failures = 0;
+    auto check = [&](bool ok, const string& what) {
+        if (!ok) {
+            cerr << "MISLUKT: " << what << endl;
+            failures++;
+        }
+    };
+
+    ResultRecord record;
+    record.solver = "find_transposition_adfgvx";
+    record.status = "interim";
+    record.model = "dutch";
+    record.input = "03-OPGAVE-adfgvx.txt";
+    record.seed = 12345678901234567ULL;
+    record.iterations = 1ULL << 40;
+    record.seconds = 12.5;
+    record.addInfo("width", 7).addInfo("blocks_done", uint64_t(986)).addInfo("offset", -3);
+    record.addInfo("cache_hit_rate", 0.817298).addInfo("shard", "1/4").addInfo("leeg", "");
+    record.addInfo("nan", numeric_limits<double>::quiet_NaN());
+    record.top.push_back({-1234.5, "4 0 6 2 1 3 5", ""});
+    record.top.push_back({-1300.25, "ABCDEFGHIKLMNOPQRSTUVWXYZ", "DIT IS \"PLAINTEXT\"\n"});
+
+    // Binair: decode(encode(x)) moet dezelfde bytes en dezelfde JSON opleveren.
+    string bytes = record.encode();
+    size_t pos = 0;
+    ResultRecord back = ResultRecord::decode(bytes, pos);
+    check(pos == bytes.size(), "decode leest de volledige record");
+    check(back.encode() == bytes, "encode(decode(encode(x))) == encode(x)");
+    check(back.toJson().dump() == record.toJson().dump(), "JSON na de binaire roundtrip: " + back.toJson().dump());
+    check(back.seed && *back.seed == 12345678901234567ULL, "seed exact");
+    check(back.info.size() == 7 && back.info[0].kind == ResultInfo::Kind::Integer && back.info[0].integer == 7,
+          "width blijft een geheel getal");
+    check(back.info.size() == 7 && back.info[2].integer == -3, "negatief geheel getal");
+    check(back.info.size() == 7 && back.info[3].kind == ResultInfo::Kind::Real && back.info[3].real == 0.817298,
+          "cache_hit_rate blijft een double");
+    check(back.info.size() == 7 && isnan(back.info[6].real), "NaN overleeft de roundtrip");
+    check(back.top.size() == 2 && back.top[1].plaintext == record.top[1].plaintext, "plaintext met escapes");
+
+    // JSON: getallen als JSON-getal, strings als string.
+    record.info.pop_back();  // NaN is geen geldig JSON-getal
+    string line = record.toJson().dump();
+    check(line.find("\"width\":7,") != string::npos, "width als JSON-getal: " + line);
+    check(line.find("\"offset\":-3,") != string::npos, "offset als JSON-getal: " + line);
+    check(line.find("\"cache_hit_rate\":0.817298,") != string::npos, "cache_hit_rate als JSON-getal: " + line);
+    check(line.find("\"shard\":\"1/4\"") != string::npos, "shard als string: " + line);
+    JsonObject json = JsonObject::parse(line);
+    check(json.getInt("blocks_done") == 986 && json.getNumber("cache_hit_rate") == 0.817298, "JSON terug inlezen: " + line);
+
+    // Twee records na elkaar, zoals in PREFIX.bin.
+    string two = bytes + record.encode();
+    pos = 0;
+    ResultRecord::decode(two, pos);
+    ResultRecord second = ResultRecord::decode(two, pos);
+    check(pos == two.size() && second.info.size() == 6, "twee records na elkaar");
+
+    // Elke afgekapte versie moet een fout geven, nooit een half record of een crash.
+    for (size_t cut = 0; cut < bytes.size(); ++cut) {
+        string truncated = bytes.substr(0, cut);
+        bool rejected = cut == 0;
+        try {
+            pos = 0;
+            if (cut > 0) ResultRecord::decode(truncated, pos);
+        } catch (const runtime_error&) {
+            rejected = true;
+        }
+        check(rejected, "afgekapt na " + to_string(cut) + " van " + to_string(bytes.size()) + " bytes wordt geweigerd");
+    }
+    // Een te korte lengte in de kop: de velden lopen over het einde van de record.
+    auto varint = [](uint64_t value) {
+        string out;
+        for (; value >= 0x80; value >>= 7) out += static_cast<char>(0x80 | (value & 0x7F));
+        return out + static_cast<char>(value);
+    };
+    size_t header = 5;
+    while (static_cast<uint8_t>(bytes[header - 1]) & 0x80) ++header;
+    string body = bytes.substr(header);
+    string short_length = bytes.substr(0, 4) + varint(body.size() - 10) + body;
+    bool rejected = false;
+    try {
+        pos = 0;
+        ResultRecord::decode(short_length, pos);
+    } catch (const runtime_error&) {
+        rejected = true;
+    }
+    check(rejected, "te korte recordlengte wordt geweigerd");
+
+    // Versie 1 (alle infovelden als string) wordt nog gelezen.
+    string v1_body;
+    for (const char* text : {"oud", "finished", "", ""}) v1_body += char(strlen(text)) + string(text);
+    v1_body += string("\0\x05", 2);                    // geen seed, 5 iteraties
+    v1_body += string(8, '\0');                         // 0.0 s
+    v1_body += string("\x01\x05width\x01" "7", 9);    // één infoveld: width = "7"
+    v1_body += string("\0", 1);                         // geen kandidaten
+    string v1 = string("CTR\x01", 4) + char(v1_body.size()) + v1_body;
+    try {
+        pos = 0;
+        ResultRecord old = ResultRecord::decode(v1, pos);
+        check(old.solver == "oud" && old.iterations == 5 && old.info.size() == 1 &&
+              old.info[0].kind == ResultInfo::Kind::Text && old.info[0].text == "7", "versie 1 lezen");
+    } catch (const exception& ex) {
+        check(false, string("versie 1 lezen: ") + ex.what());
+    }
+
+    cout << (failures ? "Zelftest mislukt." : "Zelftest geslaagd.") << endl;
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 2 && string(argv[1]) == "--selftest") return selftest();
+
+    vector<string> paths;
+    size_t top = SIZE_MAX;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        try {
+            if (arg == "--top" && i + 1 < argc) top = stoul(argv[++i]);
+            else if (arg.rfind("--", 0) == 0) {
+                cerr << "Onbekende optie: " << arg << endl;
+                return 1;
+            } else {
+                paths.push_back(arg);
+            }
+        } catch (const exception& ex) {
+            cerr << "Ongeldige waarde voor " << arg << ": " << ex.what() << endl;
+            return 1;
+        }
+    }
+    if (paths.empty()) {
+        cerr << "Gebruik: result_dump [--top K] PREFIX.bin..." << endl;
+        return 1;
+    }
+
+    try {
+        for (const string& path : paths) {
+            for (ResultRecord& record : readResultFile(path)) {
+                if (record.top.size() > top) record.top.resize(top);
+                cout << record.toJson().dump() << '\n';
+            }
+        }
+    } catch (const exception& ex) {
+        cerr << ex.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,284 @@
+// Time-to-solve-benchmark: draait de solvers (als aparte processen, zoals je ze zelf start) op
+// synthetische berichten uit bench/Workload.h, over een rooster van lengtes en breedtes.
+//
+//   cmake -S . -B build && cmake --build build -j
+//   ./build/solve_bench                                   # alle drie, standaardrooster
+//   ./build/solve_bench --ciphers vigenereplus --lengths 500,1000 --widths 12,16 --messages 5
+//
+// Per cel: aantal opgeloste berichten, mediaan en p95 van de tijd tot oplossing (over de
+// opgeloste berichten, inclusief het laden van het taalmodel) en iteraties/s van de solver.
+// Playfair en solve_square stoppen zodra ze de quadgramscore van de echte plaintext halen
+// (--target-score); een bericht telt als opgelost als de plaintext exact klopt.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <filesystem>
+#include <chrono>
+#include <iomanip>
+#include <cstdio>
+#include <unistd.h>
+
+#include "bench/Bench.h"
+#include "bench/Workload.h"
+#include "common/QuadgramScorer.h"
+
+#ifndef CODETHEORIE_SOURCE_DIR
+#define CODETHEORIE_SOURCE_DIR "."
+#endif
+
+using namespace std;
+
+vector<int> parse_list(const string& text) {
+    vector<int> values;
+    stringstream list(text);
+    for (string item; getline(list, item, ',');) values.push_back(stoi(item));
+    return values;
+}
+
+struct CommandResult {
+    int status = -1;
+    string output;     // stdout en stderr samen
+    double seconds = 0;
+};
+
+CommandResult run_command(const string& command) {
+    CommandResult result;
+    auto start = chrono::steady_clock::now();
+    FILE* pipe = popen((command + " 2>&1").c_str(), "r");
+    if (!pipe) throw runtime_error("Kon niet starten: " + command);
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), pipe)) > 0) result.output.append(buffer, n);
+    result.status = pclose(pipe);
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+string quoted(const filesystem::path& path) {
+    return "'" + path.string() + "'";
+}
+
+// De regel na 'marker' (of de rest van de regel die met 'marker' begint).
+string text_after(const string& output, const string& marker, bool next_line) {
+    size_t pos = output.rfind(marker);
+    if (pos == string::npos) return "";
+    pos += marker.size();
+    if (next_line) pos = output.find('\n', pos) + 1;
+    size_t end = output.find('\n', pos);
+    return output.substr(pos, end == string::npos ? string::npos : end - pos);
+}
+
+// Som van alle "Iteraties: N in ..."-regels (ADFGVX heeft er één per fase).
+uint64_t iterations_in(const string& output) {
+    uint64_t total = 0;
+    const string marker = "Iteraties: ";
+    for (size_t pos = output.find(marker); pos != string::npos; pos = output.find(marker, pos + 1)) {
+        total += stoull(output.substr(pos + marker.size()));
+    }
+    return total;
+}
+
+struct Attempt {
+    bool solved = false;
+    double seconds = 0;
+    uint64_t iterations = 0;
+};
+
+struct Settings {
+    filesystem::path bin;
+    filesystem::path work;              // cwd van de solvers; ../data wijst naar de echte data/
+    long playfair_iterations = 3000000;
+    long adfgvx_phase1_iterations = 5000;
+    long adfgvx_phase2_iterations = 1000000;
+    double vigenere_seconds = 60;
+};
+
+string fixed_score(double score) {
+    ostringstream out;
+    out << setprecision(12) << score - 1e-6;
+    return out.str();
+}
+
+// Doelscores met dezelfde kernels als de annealers (scoreLetters / scoreSymbolsStrict), zodat de
+// echte plaintext exact dezelfde score krijgt als in de solver.
+double letter_score(const QuadgramScorer& scorer, const string& text) {
+    vector<uint8_t> letters;
+    for (char c : text) letters.push_back(static_cast<uint8_t>(c - 'A'));
+    return scorer.scoreLetters(letters.data(), letters.size());
+}
+
+double symbol_score(const QuadgramScorer& scorer, const string& text) {
+    vector<uint8_t> symbols = QuadgramScorer::symbolIndices(text);
+    return scorer.scoreSymbolsStrict(symbols.data(), symbols.size());
+}
+
+Attempt solve_playfair(const Workload& w, const QuadgramScorer& english, const Settings& s) {
+    filesystem::path in = s.work / "cipher.txt";
+    filesystem::path out = s.work / "result.txt";
+    ofstream(in) << w.ciphertext << "\n";
+    CommandResult r = run_command("cd " + quoted(s.work) + " && " + quoted(s.bin / "playfair_cracker") +
+                                  " --in " + quoted(in) + " --out " + quoted(out) + " --model english" +
+                                  " --seed " + to_string(w.seed) + " --iterations " + to_string(s.playfair_iterations) +
+                                  " --target-score " + fixed_score(letter_score(english, w.plaintext)));
+    Attempt a;
+    a.seconds = r.seconds;
+    a.iterations = iterations_in(r.output);
+    ifstream result(out);
+    string line, last;
+    while (getline(result, line)) if (!line.empty()) last = line;
+    a.solved = r.status == 0 && last == w.plaintext;
+    return a;
+}
+
+Attempt solve_adfgvx(const Workload& w, const QuadgramScorer& spaceless, const Settings& s) {
+    filesystem::path in = s.work / "cipher.txt";
+    ofstream(in) << w.ciphertext << "\n";
+    filesystem::remove(s.work / "best_transpo_key.txt");
+    CommandResult phase1 = run_command("cd " + quoted(s.work) + " && " + quoted(s.bin / "find_transposition_adfgvx") +
+                                       " --in " + quoted(in) + " --width " + to_string(w.width) +
+                                       " --iterations " + to_string(s.adfgvx_phase1_iterations) + " --seed " + to_string(w.seed));
+    Attempt a;
+    a.seconds = phase1.seconds;
+    a.iterations = iterations_in(phase1.output);
+
+    ifstream key_file(s.work / "best_transpo_key.txt");
+    string order;
+    if (phase1.status != 0 || !getline(key_file, order)) return a;
+    replace(order.begin(), order.end(), ' ', ',');
+
+    CommandResult phase2 = run_command("cd " + quoted(s.work) + " && " + quoted(s.bin / "solve_square_adfgvx") +
+                                       " --in " + quoted(in) + " --transposition " + order +
+                                       " --iterations " + to_string(s.adfgvx_phase2_iterations) + " --seed " + to_string(w.seed) +
+                                       " --target-score " + fixed_score(symbol_score(spaceless, w.plaintext)));
+    a.seconds += phase2.seconds;
+    a.iterations += iterations_in(phase2.output);
+    a.solved = phase2.status == 0 && text_after(phase2.output, "Ontsleutelde tekst:", true) == w.plaintext;
+    return a;
+}
+
+Attempt solve_vigenereplus(const Workload& w, const Settings& s) {
+    filesystem::path in = s.work / "cipher.txt";
+    ofstream(in) << w.ciphertext << "\n";
+    CommandResult r = run_command("cd " + quoted(s.work) + " && " + quoted(s.bin / "anneal_solver") +
+                                  " --in " + quoted(in) + " --model english --widths " + to_string(w.width) +
+                                  " --seed " + to_string(w.seed) + " --seconds " + to_string(s.vigenere_seconds));
+    Attempt a;
+    a.seconds = r.seconds;
+    a.iterations = iterations_in(r.output);
+    a.solved = text_after(r.output, "Plaintext: ", false) == w.plaintext;
+    return a;
+}
+
+int main(int argc, char* argv[]) {
+    filesystem::path root = CODETHEORIE_SOURCE_DIR;
+    Settings settings;
+    settings.bin = filesystem::absolute(argv[0]).parent_path();
+    vector<string> ciphers = {"playfair", "adfgvx", "vigenereplus"};
+    vector<int> lengths;
+    vector<int> widths;
+    int messages = 3;
+    uint64_t seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("Ontbrekende waarde voor " + arg);
+            return argv[++i];
+        };
+        try {
+            if (arg == "--root") root = value();
+            else if (arg == "--bin") settings.bin = filesystem::absolute(value());
+            else if (arg == "--ciphers") {
+                ciphers.clear();
+                stringstream list(value());
+                for (string item; getline(list, item, ',');) ciphers.push_back(item);
+            }
+            else if (arg == "--lengths") lengths = parse_list(value());
+            else if (arg == "--widths") widths = parse_list(value());
+            else if (arg == "--messages") messages = max(1, stoi(value()));
+            else if (arg == "--seed") seed = stoull(value());
+            else if (arg == "--playfair-iterations") settings.playfair_iterations = stol(value());
+            else if (arg == "--adfgvx-iterations") {
+                vector<int> phases = parse_list(value());
+                settings.adfgvx_phase1_iterations = phases.at(0);
+                if (phases.size() > 1) settings.adfgvx_phase2_iterations = phases[1];
+            }
+            else if (arg == "--vigenere-seconds") settings.vigenere_seconds = stod(value());
+            else {
+                cerr << "Onbekende optie: " << arg << endl;
+                return 1;
+            }
+        } catch (const exception& ex) {
+            cerr << "Ongeldige waarde voor " << arg << ": " << ex.what() << endl;
+            return 1;
+        }
+    }
+
+    unique_ptr<WorkloadGenerator> generator;
+    unique_ptr<QuadgramScorer> english;
+    unique_ptr<QuadgramScorer> spaceless;
+    try {
+        generator = make_unique<WorkloadGenerator>((root / "data" / "corpus.txt").string());
+        english = make_unique<QuadgramScorer>((root / "data" / "english_quadgrams.txt").string());
+        spaceless = make_unique<QuadgramScorer>((root / "data" / "spaceless_english_quadgrams.txt").string());
+    } catch (const exception& ex) {
+        cerr << ex.what() << " (gebruik --root <repo>)" << endl;
+        return 1;
+    }
+
+    // Tijdelijke werkmap met een data/-link, zodat de solvers hun basePath "../" behouden en
+    // niets in de bronmap overschrijven (best_transpo_key.txt, decrypted_solution.txt).
+    filesystem::path scratch = filesystem::temp_directory_path() / ("codetheorie_bench_" + to_string(getpid()));
+    settings.work = scratch / "run";
+    filesystem::create_directories(settings.work);
+    filesystem::create_directory_symlink(filesystem::absolute(root / "data"), scratch / "data");
+
+    cout << "Time-to-solve: " << messages << " berichten per cel, seed " << seed << ", solvers uit " << settings.bin.string() << endl;
+    cout << left << setw(14) << "cijfer" << right << setw(8) << "lengte" << setw(8) << "breedte" << setw(10) << "opgelost"
+         << setw(12) << "mediaan s" << setw(10) << "p95 s" << setw(14) << "iteraties/s" << endl;
+
+    for (const string& cipher : ciphers) {
+        vector<int> cell_lengths = lengths;
+        vector<int> cell_widths = widths;
+        if (cell_lengths.empty()) cell_lengths = cipher == "vigenereplus" ? vector<int>{600, 1200} : vector<int>{300, 600};
+        if (cipher == "playfair") cell_widths = {0};
+        else if (cell_widths.empty()) cell_widths = cipher == "adfgvx" ? vector<int>{4, 5} : vector<int>{12, 16};
+
+        for (int length : cell_lengths) {
+            for (int width : cell_widths) {
+                vector<double> times;
+                uint64_t iterations = 0;
+                double seconds = 0;
+                for (int m = 0; m < messages; ++m) {
+                    Workload w;
+                    Attempt a;
+                    try {
+                        w = generator->make(cipher, length, width, seed + m);
+                        if (cipher == "playfair") a = solve_playfair(w, *english, settings);
+                        else if (cipher == "adfgvx") a = solve_adfgvx(w, *spaceless, settings);
+                        else a = solve_vigenereplus(w, settings);
+                    } catch (const exception& ex) {
+                        cerr << ex.what() << endl;
+                        filesystem::remove_all(scratch);
+                        return 1;
+                    }
+                    if (a.solved) times.push_back(a.seconds);
+                    iterations += a.iterations;
+                    seconds += a.seconds;
+                }
+                sort(times.begin(), times.end());
+                cout << left << setw(14) << cipher << right << setw(8) << length << setw(8) << (width ? to_string(width) : "-")
+                     << setw(10) << (to_string(times.size()) + "/" + to_string(messages)) << fixed << setprecision(2);
+                if (times.empty()) cout << setw(12) << "-" << setw(10) << "-";
+                else cout << setw(12) << percentile(times, 0.5) << setw(10) << percentile(times, 0.95);
+                cout << setw(14) << setprecision(0) << iterations / max(seconds, 1e-9) << endl;
+            }
+        }
+    }
+    filesystem::remove_all(scratch);
+    return 0;
+}
@@ -0,0 +1,284 @@
+#ifndef COMMON_ANNEAL_H
+#define COMMON_ANNEAL_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "AnnealProfile.h"
+#include "Random.h"
+#include "ScoreCache.h"
+
+// Generieke simulated-annealing-motor, gedeeld door Playfair, find_transposition en solve_square.
+// Alles zit in templates (geen virtuele functies), zodat de compiler de policies in de lus inlinet:
+//
+//   State     de sleutel (bv. std::string met 25 of 36 tekens); wordt ter plekke aangepast.
+//   Mutator   Move propose(State&, Rng&)   past een zet toe en geeft terug hoe hij ongedaan kan;
+//             void undo(State&, const Move&).
+//   Scorer    void decode(const State&)   ontsleutelt in zijn eigen buffer;
+//             double score()              scoort die buffer (hoger is beter).
+//   Schedule  void reset(); double temperature() const;
+//             AnnealStep step(bool new_best)    na elke iteratie: afkoelen, eventueel herstarten.
+//
+// Met enableScoreCache (common/ScoreCache.h) onthoudt de annealer scores van eerder geziene
+// sleutels; de mutator moet dan ook uint64_t hashDelta(const State&, const Move&, const ZobristTable&)
+// hebben: de verandering van de Zobrist-hash door de zet, gegeven de toestand na de zet.
+//
+// Eén Annealer per thread: de scorer-buffers en het schema zijn niet gedeeld. Het toeval komt uit
+// een Rng (common/Random.h) van de oproeper: dezelfde seed geeft dezelfde run.
+// Met CODETHEORIE_PROFILE houdt de annealer een fase-profiel bij (common/AnnealProfile.h).
+
+enum class AnnealStep { Continue, Reheat, RestartFromBest };
+
+// Geometrisch afkoelen, met optioneel een herstart na stagnation_limit iteraties zonder nieuw record:
+// de temperatuur springt naar reheat en (met restart_from_best) de zoektocht gaat verder vanaf het record.
+struct GeometricSchedule {
+    double start;
+    double cooling;
+    int stagnation_limit;            // 0 = nooit herstarten
+    double reheat;
+    bool restart_from_best;
+
+    GeometricSchedule(double start, double cooling, int stagnation_limit = 0, double reheat = 0.0,
+                      bool restart_from_best = false)
+        : start(start), cooling(cooling), stagnation_limit(stagnation_limit), reheat(reheat),
+          restart_from_best(restart_from_best), current(start) {}
+
+    void reset() {
+        current = start;
+        stagnant = 0;
+    }
+    double temperature() const { return current; }
+
+    AnnealStep step(bool new_best) {
+        current *= cooling;
+        if (stagnation_limit <= 0) return AnnealStep::Continue;
+        stagnant = new_best ? 0 : stagnant + 1;
+        if (stagnant < stagnation_limit) return AnnealStep::Continue;
+        stagnant = 0;
+        current = reheat;
+        return restart_from_best ? AnnealStep::RestartFromBest : AnnealStep::Reheat;
+    }
+
+private:
+    double current = 0.0;
+    int stagnant = 0;
+};
+
+// Zetten op een deelverzameling posities van een reeks (bv. de vrije cellen van een vierkant):
+// twee posities verwisselen, of het stuk positions[start..end) omkeren.
+class PositionMutator {
+public:
+    struct Move {
+        bool swap;
+        int a, b;
+    };
+
+    PositionMutator(std::vector<int> positions, int swap_percent)
+        : positions(std::move(positions)), swap_percent(swap_percent),
+          count(static_cast<uint32_t>(std::max<size_t>(1, this->positions.size()))) {}
+
+    // Minder dan twee posities: er valt niets te muteren.
+    bool canMove() const { return positions.size() >= 2; }
+
+    template <typename State>
+    Move propose(State& state, Rng& rng) {
+        Move move;
+        move.swap = swap_percent >= 100 || static_cast<int>(rng.below(100)) < swap_percent;
+        move.a = static_cast<int>(rng.below(count));
+        move.b = static_cast<int>(rng.below(count));
+        if (!move.swap && move.a > move.b) std::swap(move.a, move.b);
+        apply(state, move);
+        return move;
+    }
+
+    // Beide zetten zijn hun eigen inverse.
+    template <typename State>
+    void undo(State& state, const Move& move) const { apply(state, move); }
+
+    // Een swap verandert vier (positie, symbool)-termen; een omkering alle posities ertussen.
+    // Omdat de zet zijn eigen inverse is, geldt dezelfde delta ook voor undo.
+    template <typename State>
+    uint64_t hashDelta(const State& state, const Move& move, const ZobristTable& z) const {
+        if (move.swap) {
+            int pa = positions[move.a], pb = positions[move.b];
+            return z(pa, state[pa]) ^ z(pb, state[pb]) ^ z(pa, state[pb]) ^ z(pb, state[pa]);
+        }
+        uint64_t delta = 0;
+        for (int lo = move.a, hi = move.b - 1; lo < hi; ++lo, --hi) {
+            int pl = positions[lo], ph = positions[hi];
+            delta ^= z(pl, state[pl]) ^ z(ph, state[ph]) ^ z(pl, state[ph]) ^ z(ph, state[pl]);
+        }
+        return delta;
+    }
+
+private:
+    template <typename State>
+    void apply(State& state, const Move& move) const {
+        if (move.swap) {
+            std::swap(state[positions[move.a]], state[positions[move.b]]);
+            return;
+        }
+        for (int lo = move.a, hi = move.b - 1; lo < hi; ++lo, --hi) {
+            std::swap(state[positions[lo]], state[positions[hi]]);
+        }
+    }
+
+    std::vector<int> positions;
+    int swap_percent;
+    uint32_t count;
+};
+
+// Geeft de motor de kans om te rapporteren of te stoppen; alle methodes zijn optioneel
+// (erf van deze struct en overschrijf wat je nodig hebt).
+struct AnnealObserver {
+    // Nieuw record na iteratie i; false = stoppen (bv. doelscore gehaald).
+    template <typename State>
+    bool onBest(long long, const State&, double, double) { return true; }
+    // Na elke iteratie (voortgangsmeldingen, tijdsbudget, annuleren); false = stoppen.
+    bool onIteration(long long, double, double, double) { return true; }
+    // Het schema herstartte vanaf het record.
+    void onRestart(long long) {}
+};
+
+template <typename State>
+struct AnnealResult {
+    State best;
+    double best_score = 0.0;
+    long long iterations = 0;     // werkelijk uitgevoerd (minder bij vroegtijdig stoppen)
+};
+
+template <typename State, typename Mutator, typename Scorer, typename Schedule>
+class Annealer {
+public:
+    Annealer(Mutator mutator, Scorer scorer, Schedule schedule)
+        : mutator_(std::move(mutator)), scorer_(std::move(scorer)), schedule_(std::move(schedule)) {}
+
+    Mutator& mutator() { return mutator_; }
+    Scorer& scorer() { return scorer_; }
+    Schedule& schedule() { return schedule_; }
+    // Opgeteld over alle runs van deze annealer; leeg zonder CODETHEORIE_PROFILE.
+    const AnnealProfile& profile() const { return profile_; }
+
+    // Cache van 2^bits scores (16 bytes per vakje); 0 zet hem uit. Blijft over runs heen bestaan
+    // zolang de scorer dezelfde tekst scoort: na bv. een nieuwe transpositie clearScoreCache().
+    void enableScoreCache(int bits) { cache_ = bits > 0 ? ScoreCache(bits) : ScoreCache(); }
+    void clearScoreCache() { if (cache_.enabled()) cache_.clear(); }
+    const ScoreCacheStats& cacheStats() const { return cache_.stats; }
+    size_t cacheBytes() const { return cache_.bytes(); }
+
+    // Annealt vanaf 'state' (die na afloop de laatste toestand bevat, niet noodzakelijk de beste).
+    template <typename Observer = AnnealObserver>
+    AnnealResult<State> run(State& state, Rng& rng, long long iterations, Observer&& observer = Observer()) {
+        AnnealResult<State> result;
+        if constexpr (ANNEAL_PROFILE) profile_.beginRun();
+        const ZobristTable& zobrist = zobristTable();
+        const bool cached = cache_.enabled();
+        uint64_t hash = cached ? zobrist.hash(state) : 0;
+        double current = cached ? evaluateCached(state, hash) : evaluate(state);
+        result.best = state;
+        result.best_score = current;
+        schedule_.reset();
+
+        long long i = 0;
+        while (i < iterations) {
+            // Tijdstempels rond de fasen, enkel bij profilering en dan elke SAMPLE_EVERY-de iteratie.
+            uint64_t t[AnnealProfile::PHASES + 1] = {};
+            const bool sample = ANNEAL_PROFILE && (i & (AnnealProfile::SAMPLE_EVERY - 1)) == 0;
+            if constexpr (ANNEAL_PROFILE) if (sample) t[AnnealProfile::MUTATE] = profileClock();
+
+            auto move = mutator_.propose(state, rng);
+            uint64_t hash_delta = 0;
+            double candidate;
+            if (cached) {
+                // Bij een hit vallen decrypt en score weg (die fasen meten dan ~0 cycles).
+                hash_delta = mutator_.hashDelta(state, move, zobrist);
+                hash ^= hash_delta;
+                if constexpr (ANNEAL_PROFILE) if (sample) t[AnnealProfile::DECRYPT] = t[AnnealProfile::SCORE] = profileClock();
+                candidate = evaluateCached(state, hash);
+                if constexpr (ANNEAL_PROFILE) if (sample) t[AnnealProfile::ACCEPT] = profileClock();
+            } else {
+                if constexpr (ANNEAL_PROFILE) if (sample) t[AnnealProfile::DECRYPT] = profileClock();
+                scorer_.decode(state);
+                if constexpr (ANNEAL_PROFILE) if (sample) t[AnnealProfile::SCORE] = profileClock();
+                candidate = scorer_.score();
+                if constexpr (ANNEAL_PROFILE) if (sample) t[AnnealProfile::ACCEPT] = profileClock();
+            }
+
+            double delta = candidate - current;
+            double temperature = schedule_.temperature();
+            bool accepted = delta > 0 || std::exp(delta / temperature) > rng.unit();
+            if (accepted) {
+                current = candidate;
+            } else {
+                mutator_.undo(state, move);
+                hash ^= hash_delta;
+            }
+            if constexpr (ANNEAL_PROFILE) profile_.recordAcceptance(temperature, accepted);
+
+            bool new_best = current > result.best_score;
+            if (new_best) {
+                result.best = state;
+                result.best_score = current;
+            }
+            ++i;
+            if (new_best && !observer.onBest(i - 1, result.best, result.best_score, temperature)) break;
+            if (!observer.onIteration(i - 1, current, result.best_score, temperature)) break;
+
+            if (schedule_.step(new_best) == AnnealStep::RestartFromBest) {
+                state = result.best;
+                mutator_.propose(state, rng);
+                if (cached) {
+                    hash = zobrist.hash(state);
+                    current = evaluateCached(state, hash);
+                } else {
+                    current = evaluate(state);
+                }
+                observer.onRestart(i - 1);
+            }
+            if constexpr (ANNEAL_PROFILE) {
+                if (sample) {
+                    t[AnnealProfile::PHASES] = profileClock();
+                    profile_.recordSample(t);
+                }
+            }
+        }
+        if constexpr (ANNEAL_PROFILE) profile_.endRun(i);
+        result.iterations = i;
+        return result;
+    }
+
+private:
+    double evaluate(const State& state) {
+        scorer_.decode(state);
+        return scorer_.score();
+    }
+
+    // Elke TIME_EVERY-de misser wordt getimed, om de bespaarde tijd per hit te schatten.
+    double evaluateCached(const State& state, uint64_t hash) {
+        double score;
+        if (cache_.lookup(hash, score)) return score;
+        uint64_t misses = cache_.stats.lookups - cache_.stats.hits;
+        if (misses % ScoreCacheStats::TIME_EVERY == 0) {
+            auto started = std::chrono::steady_clock::now();
+            score = evaluate(state);
+            cache_.stats.timed_miss_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+            cache_.stats.timed_misses++;
+        } else {
+            score = evaluate(state);
+        }
+        cache_.store(hash, score);
+        return score;
+    }
+
+    Mutator mutator_;
+    Scorer scorer_;
+    Schedule schedule_;
+    AnnealProfile profile_;
+    ScoreCache cache_;
+};
+
+#endif // COMMON_ANNEAL_H
@@ -0,0 +1,156 @@
+#ifndef COMMON_ANNEALPROFILE_H
+#define COMMON_ANNEALPROFILE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Fase-profilering van de annealing-lus (common/Anneal.h), aan te zetten bij het compileren:
+//   cmake -DCODETHEORIE_PROFILE=ON ...   of   g++ -DCODETHEORIE_PROFILE ...
+// Uitgeschakeld valt alle meetcode weg via if constexpr; aangeschakeld wordt elke
+// SAMPLE_EVERY-de iteratie de cycle counter gelezen rond de vier fasen (mutate, decrypt, score,
+// accept) en wordt per temperatuurband geteld hoeveel zetten aanvaard worden.
+
+#ifdef CODETHEORIE_PROFILE
+constexpr bool ANNEAL_PROFILE = true;
+#else
+constexpr bool ANNEAL_PROFILE = false;
+#endif
+
+// Cycle counter (rdtsc op x86), anders nanoseconden van steady_clock.
+inline uint64_t profileClock() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+struct AnnealProfile {
+    enum Phase { MUTATE, DECRYPT, SCORE, ACCEPT, PHASES };
+    static constexpr const char* PHASE_NAMES[PHASES] = {"mutate", "decrypt", "score", "accept"};
+    static constexpr uint64_t SAMPLE_EVERY = 8;        // macht van twee
+
+    // Temperatuurbanden per macht van twee: band b dekt [2^(b+MIN_BAND), 2^(b+MIN_BAND+1)).
+    static constexpr int MIN_BAND = -6;
+    static constexpr int MAX_BAND = 8;
+    static constexpr int BANDS = MAX_BAND - MIN_BAND + 1;
+
+    uint64_t iterations = 0;
+    uint64_t sampled_iterations = 0;
+    uint64_t phase_cycles[PHASES] = {};
+    uint64_t proposed[BANDS] = {};
+    uint64_t accepted[BANDS] = {};
+    uint64_t runs = 0;
+    uint64_t run_cycles = 0;        // cycle counter over alle runs, om naar tijd om te rekenen
+    double run_seconds = 0.0;
+
+    static int band(double temperature) {
+        if (!(temperature > 0.0)) return 0;
+        return std::clamp(std::ilogb(temperature), MIN_BAND, MAX_BAND) - MIN_BAND;
+    }
+
+    void recordAcceptance(double temperature, bool was_accepted) {
+        int b = band(temperature);
+        proposed[b]++;
+        accepted[b] += was_accepted;
+    }
+
+    // t[0..PHASES]: tijdstempels voor en na elke fase.
+    void recordSample(const uint64_t (&t)[PHASES + 1]) {
+        sampled_iterations++;
+        for (int p = 0; p < PHASES; ++p) phase_cycles[p] += t[p + 1] - t[p];
+    }
+
+    void beginRun() {
+        run_start_clock = profileClock();
+        run_start_time = std::chrono::steady_clock::now();
+    }
+
+    void endRun(uint64_t run_iterations) {
+        runs++;
+        iterations += run_iterations;
+        run_cycles += profileClock() - run_start_clock;
+        run_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - run_start_time).count();
+    }
+
+    // Optellen over threads of over runs (find_transposition: één annealer per thread).
+    AnnealProfile& operator+=(const AnnealProfile& other) {
+        iterations += other.iterations;
+        sampled_iterations += other.sampled_iterations;
+        for (int p = 0; p < PHASES; ++p) phase_cycles[p] += other.phase_cycles[p];
+        for (int b = 0; b < BANDS; ++b) {
+            proposed[b] += other.proposed[b];
+            accepted[b] += other.accepted[b];
+        }
+        runs += other.runs;
+        run_cycles += other.run_cycles;
+        run_seconds += other.run_seconds;
+        return *this;
+    }
+
+private:
+    uint64_t run_start_clock = 0;
+    std::chrono::steady_clock::time_point run_start_time;
+};
+
+// Schrijft het profiel als JSON: per fase cycles en ns per iteratie en het aandeel in de lus,
+// en per temperatuurband het aantal voorgestelde en aanvaarde zetten.
+inline void writeAnnealProfile(const AnnealProfile& profile, const std::string& label, const std::string& path) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Kon profiel niet schrijven naar " + path);
+
+    double cycles_per_ns = profile.run_seconds > 0 ? profile.run_cycles / (profile.run_seconds * 1e9) : 1.0;
+    double samples = std::max<uint64_t>(profile.sampled_iterations, 1);
+    uint64_t loop_cycles = 0;
+    for (uint64_t c : profile.phase_cycles) loop_cycles += c;
+
+    out << std::setprecision(6);
+    out << "{\n";
+    out << "  \"label\": \"" << label << "\",\n";
+    out << "  \"runs\": " << profile.runs << ",\n";
+    out << "  \"iterations\": " << profile.iterations << ",\n";
+    out << "  \"seconds\": " << profile.run_seconds << ",\n";
+    out << "  \"iterations_per_second\": " << (profile.run_seconds > 0 ? profile.iterations / profile.run_seconds : 0.0) << ",\n";
+    out << "  \"sample_every\": " << AnnealProfile::SAMPLE_EVERY << ",\n";
+    out << "  \"sampled_iterations\": " << profile.sampled_iterations << ",\n";
+    out << "  \"cycles_per_ns\": " << cycles_per_ns << ",\n";
+    out << "  \"phases\": {\n";
+    for (int p = 0; p < AnnealProfile::PHASES; ++p) {
+        double cycles = profile.phase_cycles[p] / samples;
+        out << "    \"" << AnnealProfile::PHASE_NAMES[p] << "\": {\"cycles_per_iteration\": " << cycles
+            << ", \"ns_per_iteration\": " << cycles / cycles_per_ns
+            << ", \"share\": " << (loop_cycles ? double(profile.phase_cycles[p]) / loop_cycles : 0.0) << "}"
+            << (p + 1 < AnnealProfile::PHASES ? "," : "") << "\n";
+    }
+    out << "  },\n";
+    out << "  \"acceptance\": [";
+    bool first = true;
+    for (int b = 0; b < AnnealProfile::BANDS; ++b) {
+        if (profile.proposed[b] == 0) continue;
+        int exponent = b + AnnealProfile::MIN_BAND;
+        out << (first ? "\n" : ",\n");
+        first = false;
+        // De buitenste banden zijn open: alles onder 2^MIN_BAND of boven 2^MAX_BAND valt erin.
+        out << "    {\"t_min\": " << (exponent == AnnealProfile::MIN_BAND ? 0.0 : std::ldexp(1.0, exponent))
+            << ", \"t_max\": ";
+        if (exponent == AnnealProfile::MAX_BAND) out << "null";
+        else out << std::ldexp(1.0, exponent + 1);
+        out << ", \"proposed\": " << profile.proposed[b] << ", \"accepted\": " << profile.accepted[b]
+            << ", \"rate\": " << double(profile.accepted[b]) / profile.proposed[b] << "}";
+    }
+    out << (first ? "]\n" : "\n  ]\n");
+    out << "}\n";
+}
+
+#endif // COMMON_ANNEALPROFILE_H
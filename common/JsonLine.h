@@ -0,0 +1,233 @@
+#ifndef COMMON_JSONLINE_H
+#define COMMON_JSONLINE_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <type_traits>
+#include <cstdio>
+
+// Eén plat JSON-object per regel (JSON lines), voor de solver-daemon en zijn client.
+// Waarden zijn strings, getallen, true/false of null; geneste objecten en arrays worden
+// niet ondersteund. De volgorde van de sleutels blijft behouden bij het wegschrijven.
+class JsonObject {
+public:
+    static JsonObject parse(const std::string& line) {
+        JsonObject object;
+        size_t pos = 0;
+        skipSpace(line, pos);
+        expect(line, pos, '{');
+        skipSpace(line, pos);
+        if (pos < line.size() && line[pos] == '}') return object;
+        while (true) {
+            skipSpace(line, pos);
+            std::string key = parseString(line, pos);
+            skipSpace(line, pos);
+            expect(line, pos, ':');
+            skipSpace(line, pos);
+            object.fields.emplace_back(std::move(key), parseValue(line, pos));
+            skipSpace(line, pos);
+            if (pos < line.size() && line[pos] == ',') {
+                ++pos;
+                continue;
+            }
+            expect(line, pos, '}');
+            break;
+        }
+        skipSpace(line, pos);
+        if (pos != line.size()) throw std::invalid_argument("JSON: tekst na het object");
+        return object;
+    }
+
+    bool has(const std::string& key) const { return find(key) != nullptr; }
+
+    std::string getString(const std::string& key, const std::string& fallback = "") const {
+        const Value* v = find(key);
+        return v && v->kind != Kind::Null ? v->text : fallback;
+    }
+
+    double getNumber(const std::string& key, double fallback = 0.0) const {
+        const Value* v = find(key);
+        if (!v || v->kind == Kind::Null) return fallback;
+        try {
+            return std::stod(v->text);
+        } catch (const std::exception&) {
+            throw std::invalid_argument("JSON: '" + key + "' is geen getal");
+        }
+    }
+
+    long long getInt(const std::string& key, long long fallback = 0) const {
+        const Value* v = find(key);
+        if (!v || v->kind == Kind::Null) return fallback;
+        try {
+            return std::stoll(v->text);
+        } catch (const std::exception&) {
+            throw std::invalid_argument("JSON: '" + key + "' is geen geheel getal");
+        }
+    }
+
+    unsigned long long getUnsigned(const std::string& key, unsigned long long fallback = 0) const {
+        const Value* v = find(key);
+        if (!v || v->kind == Kind::Null) return fallback;
+        try {
+            if (v->text.find('-') != std::string::npos) throw std::invalid_argument(key);
+            return std::stoull(v->text);
+        } catch (const std::exception&) {
+            throw std::invalid_argument("JSON: '" + key + "' is geen natuurlijk getal");
+        }
+    }
+
+    bool getBool(const std::string& key, bool fallback = false) const {
+        const Value* v = find(key);
+        if (!v || v->kind == Kind::Null) return fallback;
+        return v->text == "true" || v->text == "1";
+    }
+
+    JsonObject& set(const std::string& key, const std::string& value) { return put(key, {Kind::String, value}); }
+    JsonObject& set(const std::string& key, const char* value) { return put(key, {Kind::String, value}); }
+    JsonObject& set(const std::string& key, bool value) { return put(key, {Kind::Bool, value ? "true" : "false"}); }
+    JsonObject& set(const std::string& key, double value) {
+        std::ostringstream out;
+        out << std::setprecision(10) << value;
+        return put(key, {Kind::Number, out.str()});
+    }
+    template <typename Integer, typename = std::enable_if_t<std::is_integral_v<Integer>>>
+    JsonObject& set(const std::string& key, Integer value) { return put(key, {Kind::Number, std::to_string(value)}); }
+
+    // Neemt alle velden van 'other' over (bestaande sleutels worden overschreven).
+    JsonObject& merge(const JsonObject& other) {
+        for (const auto& field : other.fields) put(field.first, field.second);
+        return *this;
+    }
+
+    std::string dump() const {
+        std::string out = "{";
+        for (size_t i = 0; i < fields.size(); ++i) {
+            if (i) out += ",";
+            out += quote(fields[i].first) + ":";
+            out += fields[i].second.kind == Kind::String ? quote(fields[i].second.text) : fields[i].second.text;
+        }
+        return out + "}";
+    }
+
+    static std::string quote(const std::string& text) {
+        std::string out = "\"";
+        for (char c : text) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char buffer[8];
+                        std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                        out += buffer;
+                    } else {
+                        out += c;
+                    }
+            }
+        }
+        return out + "\"";
+    }
+
+private:
+    enum class Kind { String, Number, Bool, Null };
+    struct Value {
+        Kind kind;
+        std::string text;
+    };
+
+    std::vector<std::pair<std::string, Value>> fields;
+
+    const Value* find(const std::string& key) const {
+        for (const auto& field : fields) {
+            if (field.first == key) return &field.second;
+        }
+        return nullptr;
+    }
+
+    JsonObject& put(const std::string& key, Value value) {
+        for (auto& field : fields) {
+            if (field.first == key) {
+                field.second = std::move(value);
+                return *this;
+            }
+        }
+        fields.emplace_back(key, std::move(value));
+        return *this;
+    }
+
+    static void skipSpace(const std::string& s, size_t& pos) {
+        while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\t' || s[pos] == '\r' || s[pos] == '\n')) ++pos;
+    }
+
+    static void expect(const std::string& s, size_t& pos, char c) {
+        if (pos >= s.size() || s[pos] != c) {
+            throw std::invalid_argument(std::string("JSON: '") + c + "' verwacht op positie " + std::to_string(pos));
+        }
+        ++pos;
+    }
+
+    static std::string parseString(const std::string& s, size_t& pos) {
+        expect(s, pos, '"');
+        std::string out;
+        while (pos < s.size() && s[pos] != '"') {
+            char c = s[pos++];
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos >= s.size()) break;
+            char e = s[pos++];
+            switch (e) {
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    if (pos + 4 > s.size()) throw std::invalid_argument("JSON: onvolledige \\u-escape");
+                    unsigned code = std::stoul(s.substr(pos, 4), nullptr, 16);
+                    pos += 4;
+                    // Als UTF-8 (zonder surrogaatparen: de ciphertexts zijn ASCII).
+                    if (code < 0x80) {
+                        out += static_cast<char>(code);
+                    } else if (code < 0x800) {
+                        out += static_cast<char>(0xC0 | (code >> 6));
+                        out += static_cast<char>(0x80 | (code & 0x3F));
+                    } else {
+                        out += static_cast<char>(0xE0 | (code >> 12));
+                        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                        out += static_cast<char>(0x80 | (code & 0x3F));
+                    }
+                    break;
+                }
+                default: out += e;   // \" \\ \/
+            }
+        }
+        expect(s, pos, '"');
+        return out;
+    }
+
+    static Value parseValue(const std::string& s, size_t& pos) {
+        if (pos >= s.size()) throw std::invalid_argument("JSON: waarde verwacht");
+        if (s[pos] == '"') return {Kind::String, parseString(s, pos)};
+        if (s[pos] == '{' || s[pos] == '[') throw std::invalid_argument("JSON: geneste waarden worden niet ondersteund");
+        size_t start = pos;
+        while (pos < s.size() && s[pos] != ',' && s[pos] != '}' && s[pos] != ' ' && s[pos] != '\t') ++pos;
+        std::string token = s.substr(start, pos - start);
+        if (token == "true" || token == "false") return {Kind::Bool, token};
+        if (token == "null") return {Kind::Null, ""};
+        if (token.empty() || token.find_first_not_of("+-0123456789.eE") != std::string::npos) {
+            throw std::invalid_argument("JSON: ongeldige waarde '" + token + "'");
+        }
+        return {Kind::Number, token};
+    }
+};
+
+#endif // COMMON_JSONLINE_H
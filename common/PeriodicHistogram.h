@@ -0,0 +1,292 @@
+#ifndef COMMON_PERIODICHISTOGRAM_H
+#define COMMON_PERIODICHISTOGRAM_H
+
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <stdexcept>
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PERIODIC_HISTOGRAM_X86 1
+#endif
+
+// --- Letterhistogrammen van periodieke slices ---
+// Slice (L, i) van een tekst zijn de posities j met j % L == i. Voor de IC-tests van
+// Vigenère hebben we de histogrammen van alle slices van één periode, of van alle
+// periodes 1..10 tegelijk, nodig.
+//
+// De vectorkernels tellen per "baan" (positie in het register): met een blokstap die een
+// veelvoud is van L valt baan k altijd in slice k % L. Per blok kost dat per letter één
+// vergelijking en één aftrekking op 32/64 byte-tellers; pas na 255 blokken worden de banen
+// opgeteld. Met stap 60 (AVX-512) zijn de periodes 1-6 en 10 in één doorloop klaar, met 56
+// de periodes 7 en 8 en met 63 periode 9.
+//
+// De kernel wordt bij het opstarten gekozen (AVX-512BW, AVX2 of scalair). De uitkomst is
+// voor elke kernel exact dezelfde.
+
+enum class HistogramKernel { Scalar, AVX2, AVX512 };
+
+inline const char* histogramKernelName(HistogramKernel kernel) {
+    switch (kernel) {
+        case HistogramKernel::AVX512: return "avx512";
+        case HistogramKernel::AVX2:   return "avx2";
+        default:                      return "scalar";
+    }
+}
+
+inline bool histogramKernelSupported(HistogramKernel kernel) {
+#ifdef PERIODIC_HISTOGRAM_X86
+    if (kernel == HistogramKernel::AVX512) return __builtin_cpu_supports("avx512bw");
+    if (kernel == HistogramKernel::AVX2) return __builtin_cpu_supports("avx2");
+#endif
+    return kernel == HistogramKernel::Scalar;
+}
+
+// Snelste kernel die deze processor ondersteunt (één keer bepaald).
+inline HistogramKernel bestHistogramKernel() {
+    static const HistogramKernel best =
+        histogramKernelSupported(HistogramKernel::AVX512) ? HistogramKernel::AVX512 :
+        histogramKernelSupported(HistogramKernel::AVX2) ? HistogramKernel::AVX2 : HistogramKernel::Scalar;
+    return best;
+}
+
+struct PeriodicHistograms {
+    static const int MAX_PERIOD = 10;
+
+    // counts[L][i][x]: aantal keer letter x ('A' + x) in slice i van periode L.
+    uint32_t counts[MAX_PERIOD + 1][MAX_PERIOD][26];
+    // lengths[L][i]: lengte van slice i van periode L (alle tekens, ook niet-letters).
+    uint32_t lengths[MAX_PERIOD + 1][MAX_PERIOD];
+};
+
+namespace periodic_histogram_detail {
+
+// Baanhistogram: lanes[k][x] telt de verwerkte posities j met j % stride == k en tekst[j] == 'A' + x.
+// De letters zijn opgevuld tot 32, zodat het vouwen per baan over alle letters tegelijk vectoriseert.
+// De hulpfuncties worden in de vectorkernels ingelijnd en dus ook met AVX2/AVX-512 gecompileerd.
+typedef uint32_t LaneCounts[64][32];
+
+__attribute__((always_inline)) inline void foldBytes(const uint8_t (*bytes)[64], int stride, LaneCounts& lanes) {
+    for (int k = 0; k < stride; ++k) {
+        for (int x = 0; x < 26; ++x) lanes[k][x] += bytes[x][k];
+    }
+}
+
+// Grootste veelvoud van alle `periods` dat in een register van `width` bytes past.
+inline int strideFor(const int* periods, int count, int width) {
+    int lcm = 1;
+    for (int i = 0; i < count; ++i) {
+        int a = lcm, b = periods[i];
+        while (b != 0) { int t = a % b; a = b; b = t; }
+        lcm = lcm / a * periods[i];
+    }
+    return width / lcm * lcm;
+}
+
+// Zet de banen om naar de slices van elke periode. Van groot naar klein: een periode p wordt
+// gevouwen uit de kleinste al berekende periode q met p | q (60 -> 10 -> 5 ...), niet telkens
+// uit alle banen.
+__attribute__((always_inline)) inline void foldPeriods(const LaneCounts& lanes, int stride,
+                                                      const int* periods, int count,
+                                                      uint32_t (*counts)[PeriodicHistograms::MAX_PERIOD][26]) {
+    const int MAX_PERIOD = PeriodicHistograms::MAX_PERIOD;
+    alignas(64) uint32_t folded[MAX_PERIOD + 1][MAX_PERIOD][32];
+    bool have[MAX_PERIOD + 1] = {};
+    for (int p = MAX_PERIOD; p >= 1; --p) {
+        if (std::find(periods, periods + count, p) == periods + count) continue;
+        const uint32_t (*source)[32] = lanes;
+        int source_len = stride;
+        for (int q = p + 1; q <= MAX_PERIOD; ++q) {
+            if (have[q] && q % p == 0) { source = folded[q]; source_len = q; break; }
+        }
+        std::memset(folded[p], 0, sizeof(folded[p]));
+        for (int k = 0, i = 0; k < source_len; ++k) {
+            for (int x = 0; x < 32; ++x) folded[p][i][x] += source[k][x];
+            if (++i == p) i = 0;
+        }
+        have[p] = true;
+        for (int i = 0; i < p; ++i) {
+            for (int x = 0; x < 26; ++x) counts[p][i][x] += folded[p][i][x];
+        }
+    }
+}
+
+#ifdef PERIODIC_HISTOGRAM_X86
+__attribute__((target("avx512bw")))
+inline size_t countPeriodsAVX512(const char* text, size_t n, const int* periods, int count,
+                                 uint32_t (*counts)[PeriodicHistograms::MAX_PERIOD][26]) {
+    const int stride = strideFor(periods, count, 64);
+    alignas(64) LaneCounts lanes;
+    std::memset(lanes, 0, sizeof(lanes));
+    __m512i acc[26];
+    for (int x = 0; x < 26; ++x) acc[x] = _mm512_setzero_si512();
+    const __m512i one = _mm512_set1_epi8(1);
+    alignas(64) uint8_t bytes[26][64];
+
+    size_t start = 0;
+    int blocks = 0;
+    // Banen >= stride worden gelezen maar niet opgeteld: die posities telt het volgende blok.
+    while (start + 64 <= n) {
+        __m512i v = _mm512_loadu_si512(text + start);
+        // Volledig uitrollen: zo blijven de 26 tellers in registers.
+#pragma GCC unroll 26
+        for (int x = 0; x < 26; ++x) {
+            __mmask64 eq = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(static_cast<char>('A' + x)));
+            acc[x] = _mm512_mask_add_epi8(acc[x], eq, acc[x], one);
+        }
+        start += stride;
+        if (++blocks == 255) {
+            for (int x = 0; x < 26; ++x) {
+                _mm512_store_si512(bytes[x], acc[x]);
+                acc[x] = _mm512_setzero_si512();
+            }
+            foldBytes(bytes, stride, lanes);
+            blocks = 0;
+        }
+    }
+    for (int x = 0; x < 26; ++x) _mm512_store_si512(bytes[x], acc[x]);
+    foldBytes(bytes, stride, lanes);
+    foldPeriods(lanes, stride, periods, count, counts);
+    return start;
+}
+
+__attribute__((target("avx2")))
+inline size_t countPeriodsAVX2(const char* text, size_t n, const int* periods, int count,
+                               uint32_t (*counts)[PeriodicHistograms::MAX_PERIOD][26]) {
+    const int stride = strideFor(periods, count, 32);
+    alignas(64) LaneCounts lanes;
+    std::memset(lanes, 0, sizeof(lanes));
+    __m256i acc[26];
+    for (int x = 0; x < 26; ++x) acc[x] = _mm256_setzero_si256();
+    alignas(32) uint8_t bytes[26][64];
+
+    size_t start = 0;
+    int blocks = 0;
+    while (start + 32 <= n) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + start));
+#pragma GCC unroll 26
+        for (int x = 0; x < 26; ++x) {
+            // Gelijk geeft 0xFF (= -1): aftrekken telt één bij.
+            acc[x] = _mm256_sub_epi8(acc[x], _mm256_cmpeq_epi8(v, _mm256_set1_epi8(static_cast<char>('A' + x))));
+        }
+        start += stride;
+        if (++blocks == 255) {
+            for (int x = 0; x < 26; ++x) {
+                _mm256_store_si256(reinterpret_cast<__m256i*>(bytes[x]), acc[x]);
+                acc[x] = _mm256_setzero_si256();
+            }
+            foldBytes(bytes, stride, lanes);
+            blocks = 0;
+        }
+    }
+    for (int x = 0; x < 26; ++x) _mm256_store_si256(reinterpret_cast<__m256i*>(bytes[x]), acc[x]);
+    foldBytes(bytes, stride, lanes);
+    foldPeriods(lanes, stride, periods, count, counts);
+    return start;
+}
+#endif
+
+// Telt periodes `periods` van de tekst in `counts`: één vectordoorloop met een stap die een
+// veelvoud is van alle periodes, de staart (< één register) wordt scalair geteld.
+inline void countPeriods(HistogramKernel kernel, const char* text, size_t n, const int* periods, int count,
+                         uint32_t (*counts)[PeriodicHistograms::MAX_PERIOD][26]) {
+    size_t done = 0;
+#ifdef PERIODIC_HISTOGRAM_X86
+    if (kernel == HistogramKernel::AVX512) done = countPeriodsAVX512(text, n, periods, count, counts);
+    if (kernel == HistogramKernel::AVX2) done = countPeriodsAVX2(text, n, periods, count, counts);
+#endif
+
+    // Scalair: per periode en per slice een gewone lus met stap L.
+    for (int p = 0; p < count; ++p) {
+        int period = periods[p];
+        for (int i = 0; i < period; ++i) {
+            uint32_t* slice = counts[period][i];
+            size_t first = done + i;
+            for (size_t j = first; j < n; j += period) {
+                unsigned x = static_cast<unsigned char>(text[j]) - 'A';
+                if (x < 26) slice[x]++;
+            }
+        }
+    }
+}
+
+}  // namespace periodic_histogram_detail
+
+// Histogrammen van alle slices van alle periodes 1..10 van `text` (hoofdletters A-Z).
+inline void periodicHistograms(const std::string& text, PeriodicHistograms& out,
+                               HistogramKernel kernel = bestHistogramKernel()) {
+    using namespace periodic_histogram_detail;
+    std::memset(&out, 0, sizeof(out));
+    const char* data = text.data();
+    size_t n = text.length();
+
+    for (int period = 1; period <= PeriodicHistograms::MAX_PERIOD; ++period) {
+        for (int i = 0; i < period; ++i) {
+            out.lengths[period][i] = n > static_cast<size_t>(i) ? static_cast<uint32_t>((n - i + period - 1) / period) : 0;
+        }
+    }
+
+    if (kernel == HistogramKernel::Scalar) {
+        static const int all[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+        countPeriods(kernel, data, n, all, 10, out.counts);
+    } else if (kernel == HistogramKernel::AVX512) {
+        static const int pass_60[] = {1, 2, 3, 4, 5, 6, 10};
+        static const int pass_56[] = {7, 8};
+        static const int pass_63[] = {9};
+        countPeriods(kernel, data, n, pass_60, 7, out.counts);
+        countPeriods(kernel, data, n, pass_56, 2, out.counts);
+        countPeriods(kernel, data, n, pass_63, 1, out.counts);
+    } else {
+        static const int pass_30[] = {1, 2, 3, 5, 6, 10};
+        static const int pass_28[] = {4, 7};
+        static const int pass_24[] = {8};
+        static const int pass_27[] = {9};
+        countPeriods(kernel, data, n, pass_30, 6, out.counts);
+        countPeriods(kernel, data, n, pass_28, 2, out.counts);
+        countPeriods(kernel, data, n, pass_24, 1, out.counts);
+        countPeriods(kernel, data, n, pass_27, 1, out.counts);
+    }
+}
+
+// Histogrammen van de `period` slices van één periode (1..10) in één doorloop.
+// counts[i][x] = aantal keer 'A' + x in slice i.
+inline void sliceHistograms(const std::string& text, int period, uint32_t (*counts)[26],
+                            HistogramKernel kernel = bestHistogramKernel()) {
+    using namespace periodic_histogram_detail;
+    if (period < 1 || period > PeriodicHistograms::MAX_PERIOD) {
+        throw std::invalid_argument("sliceHistograms: periode moet tussen 1 en 10 liggen.");
+    }
+    uint32_t buffer[PeriodicHistograms::MAX_PERIOD + 1][PeriodicHistograms::MAX_PERIOD][26];
+    std::memset(buffer[period], 0, sizeof(buffer[period]));
+    countPeriods(kernel, text.data(), text.length(), &period, 1, buffer);
+    std::memcpy(counts, buffer[period], sizeof(uint32_t) * 26 * period);
+}
+
+// Som van c*(c-1) over een histogram: de teller van de IC, exact als geheel getal.
+inline uint64_t coincidenceSum(const uint32_t* counts) {
+    uint64_t sum = 0;
+    for (int x = 0; x < 26; ++x) sum += static_cast<uint64_t>(counts[x]) * (counts[x] - 1u);
+    return sum;
+}
+
+// IC van één slice; bit-identiek aan calculate_ic op dezelfde tekens.
+inline double sliceIC(const uint32_t* counts, size_t length) {
+    if (length <= 1) return 0.0;
+    return static_cast<double>(coincidenceSum(counts)) / (length * (length - 1));
+}
+
+// Gemiddelde IC over de slices van elke periode: avg_ic[L] voor L = 1..10 (avg_ic[0] = 0).
+// Zelfde optelvolgorde als score_vigenere_potential, dus dezelfde doubles.
+inline void periodICs(const PeriodicHistograms& h, double (&avg_ic)[PeriodicHistograms::MAX_PERIOD + 1]) {
+    avg_ic[0] = 0.0;
+    for (int period = 1; period <= PeriodicHistograms::MAX_PERIOD; ++period) {
+        double total_ic = 0.0;
+        for (int i = 0; i < period; ++i) total_ic += sliceIC(h.counts[period][i], h.lengths[period][i]);
+        avg_ic[period] = total_ic / period;
+    }
+}
+
+#endif // COMMON_PERIODICHISTOGRAM_H
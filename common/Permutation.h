@@ -0,0 +1,77 @@
+#ifndef COMMON_PERMUTATION_H
+#define COMMON_PERMUTATION_H
+
+#include <cstdint>
+#include <vector>
+#include <stdexcept>
+
+// n! als 64-bit getal (geldig tot en met n = 20).
+inline uint64_t factorial(int n) {
+    if (n < 0 || n > 20) {
+        throw std::invalid_argument("factorial: n moet tussen 0 en 20 liggen.");
+    }
+    uint64_t result = 1;
+    for (int i = 2; i <= n; ++i) result *= i;
+    return result;
+}
+
+// Geeft de permutatie van 0..n-1 met lexicografische rang `rank`, dus exact de volgorde
+// waarin std::next_permutation ze vanaf {0, 1, ..., n-1} aflevert.
+inline std::vector<int> permutationFromRank(int n, uint64_t rank) {
+    if (rank >= factorial(n)) {
+        throw std::out_of_range("permutationFromRank: rang buiten bereik.");
+    }
+    std::vector<int> pool(n);
+    for (int i = 0; i < n; ++i) pool[i] = i;
+
+    std::vector<int> perm;
+    perm.reserve(n);
+    for (int i = n; i >= 1; --i) {
+        uint64_t f = factorial(i - 1);
+        uint64_t digit = rank / f;
+        rank %= f;
+        perm.push_back(pool[digit]);
+        pool.erase(pool.begin() + digit);
+    }
+    return perm;
+}
+
+// Omgekeerde van permutationFromRank.
+inline uint64_t rankOfPermutation(const std::vector<int>& perm) {
+    int n = static_cast<int>(perm.size());
+    uint64_t rank = 0;
+    for (int i = 0; i < n; ++i) {
+        uint64_t smaller_after = 0;
+        for (int j = i + 1; j < n; ++j) {
+            if (perm[j] < perm[i]) ++smaller_after;
+        }
+        rank += smaller_after * factorial(n - 1 - i);
+    }
+    return rank;
+}
+
+// Geeft de permutatie op plaats `index` in de Steinhaus-Johnson-Trotter-volgorde ("plain changes"):
+// opeenvolgende permutaties verschillen in één wissel van twee naburige posities. Recursief:
+// permutatie k van n elementen is permutatie k / n van n-1 elementen met het grootste element
+// ingevoegd op plaats n-1-(k % n) (even k / n, van rechts naar links) of k % n (oneven).
+inline std::vector<int> permutationFromSjtIndex(int n, uint64_t index) {
+    if (index >= factorial(n)) {
+        throw std::out_of_range("permutationFromSjtIndex: index buiten bereik.");
+    }
+    std::vector<uint64_t> offset(n + 1), parent(n + 1);
+    for (int m = n; m >= 2; --m) {
+        offset[m] = index % m;
+        index /= m;
+        parent[m] = index;
+    }
+    std::vector<int> perm;
+    perm.reserve(n);
+    if (n > 0) perm.push_back(0);
+    for (int m = 2; m <= n; ++m) {
+        uint64_t pos = parent[m] % 2 == 0 ? m - 1 - offset[m] : offset[m];
+        perm.insert(perm.begin() + pos, m - 1);
+    }
+    return perm;
+}
+
+#endif // COMMON_PERMUTATION_H
@@ -0,0 +1,229 @@
+#ifndef COMMON_QUADGRAMSCORER_H
+#define COMMON_QUADGRAMSCORER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <cmath>
+#include <numeric>
+#include <cctype>
+#include <cstdint>
+#include <stdexcept>
+
+#include "TablePlacement.h"
+
+// Quadgram-taalmodel, gedeeld door alle solvers.
+// score/score_tolerant/score_strict werken op gewone tekst (zoals vroeger per map);
+// scoreLetters werkt op letterindices 0..25 via een vlakke tabel van 26^4 entries en is
+// bedoeld voor binnenlussen (annealing). Met placeTable komt die tabel op huge pages en/of
+// in een kopie per NUMA-knoop (common/TablePlacement.h); standaard is het een gewone vector.
+class QuadgramScorer {
+public:
+    static const size_t TABLE_SIZE = 26 * 26 * 26 * 26;
+
+    explicit QuadgramScorer(const std::string& quadgram_filepath) {
+        std::ifstream file(quadgram_filepath);
+        if (!file.is_open()) {
+            throw std::runtime_error("Kon quadgram-bestand niet openen: " + quadgram_filepath);
+        }
+
+        std::string quadgram;
+        long long count;
+        long long total_count = 0;
+        std::map<std::string, long long> counts;
+
+        while (file >> quadgram >> count) {
+            counts[quadgram] = count;
+            total_count += count;
+        }
+        if (total_count == 0) {
+            throw std::runtime_error("Leeg quadgram-bestand: " + quadgram_filepath);
+        }
+
+        // Bereken log-waarschijnlijkheden voor numerieke stabiliteit
+        for (auto const& [key, val] : counts) {
+            log_probabilities[key] = log10(static_cast<double>(val) / total_count);
+        }
+
+        // Een "bodem" score voor quadgrams die niet in onze lijst staan
+        floor_prob = log10(0.01 / total_count);
+
+        // Vlakke tabel voor A-Z; andere quadgrams (accenten in de Franse/Spaanse modellen)
+        // tellen wel mee in total_count, maar kunnen in letterindices niet voorkomen.
+        letter_table.assign(TABLE_SIZE, static_cast<float>(floor_prob));
+        std::vector<double> first_letter(26, 0.0);
+        for (auto const& [key, val] : counts) {
+            if (key.size() != 4) continue;
+            size_t index = 0;
+            bool letters_only = true;
+            for (char c : key) {
+                if (c < 'A' || c > 'Z') { letters_only = false; break; }
+                index = index * 26 + (c - 'A');
+            }
+            if (!letters_only) continue;
+            letter_table[index] = static_cast<float>(log_probabilities[key]);
+            first_letter[key[0] - 'A'] += static_cast<double>(val);
+        }
+        double letters_total = std::accumulate(first_letter.begin(), first_letter.end(), 0.0);
+        for (int x = 0; x < 26; ++x) {
+            letter_frequencies[x] = letters_total > 0 ? first_letter[x] / letters_total : 1.0 / 26;
+        }
+    }
+
+    // Berekent de fitness-score van een gegeven tekst
+    double score(const std::string& text) const {
+        double total_score = 0.0;
+        for (size_t i = 0; i + 3 < text.length(); ++i) {
+            std::string quad = text.substr(i, 4);
+            auto it = log_probabilities.find(quad);
+            if (it != log_probabilities.end()) {
+                total_score += it->second;
+            } else {
+                total_score += floor_prob;
+            }
+        }
+        return total_score;
+    }
+
+    // --- TOLERANT (voor find_transposition) ---
+    // Negeert quadgrams met cijfers, bestraft ze niet.
+    double score_tolerant(const std::string& text) const {
+        double total_score = 0.0;
+        if (text.length() < 4) {
+            return floor_prob * 4.0;
+        }
+
+        for (size_t i = 0; i + 3 < text.length(); ++i) {
+            char c1 = text[i];
+            char c2 = text[i+1];
+            char c3 = text[i+2];
+            char c4 = text[i+3];
+
+            if (std::isalpha(static_cast<unsigned char>(c1)) &&
+                std::isalpha(static_cast<unsigned char>(c2)) &&
+                std::isalpha(static_cast<unsigned char>(c3)) &&
+                std::isalpha(static_cast<unsigned char>(c4))) {
+
+                std::string quad;
+                quad += std::toupper(static_cast<unsigned char>(c1));
+                quad += std::toupper(static_cast<unsigned char>(c2));
+                quad += std::toupper(static_cast<unsigned char>(c3));
+                quad += std::toupper(static_cast<unsigned char>(c4));
+
+                auto it = log_probabilities.find(quad);
+                total_score += (it != log_probabilities.end()) ? it->second : floor_prob;
+            }
+        }
+        return total_score;
+    }
+
+    // --- STRIKT (voor solve_square) ---
+    // Bestraft quadgrams met cijfers.
+    double score_strict(const std::string& text) const {
+        std::string clean;
+        clean.reserve(text.size());
+        for (char c : text) {
+            if (std::isalnum(static_cast<unsigned char>(c))) {
+                clean += std::toupper(static_cast<unsigned char>(c));
+            }
+        }
+
+        if (clean.size() < 4) return floor_prob * 4.0;
+
+        double total_score = 0.0;
+        for (size_t i = 0; i + 3 < clean.length(); ++i) {
+            std::string quad = clean.substr(i, 4);
+            auto it = log_probabilities.find(quad);
+            total_score += (it != log_probabilities.end()) ? it->second : floor_prob;
+        }
+        return total_score;
+    }
+
+    // --- SNEL (letterindices 0..25) ---
+    double scoreLetters(const uint8_t* letters, size_t n) const {
+        if (n < 4) return 0.0;
+        const float* table = placed_table.local(letter_table.data());
+        // Elke index apart uitrekenen (geen rollende index): zo hangen de lookups niet van
+        // elkaar af en kan de processor er veel tegelijk laten lopen.
+        double total_score = 0.0;
+        for (size_t i = 0; i + 3 < n; ++i) {
+            size_t index = ((letters[i] * 26 + letters[i + 1]) * 26 + letters[i + 2]) * 26 + letters[i + 3];
+            total_score += table[index];
+        }
+        return total_score;
+    }
+
+    // --- SNEL MET CIJFERS (symboolindices: A-Z = 0..25, 0-9 = 26..35, zie symbolIndex) ---
+    // Zelfde uitkomst als score_tolerant/score_strict op de overeenkomstige tekst, op de
+    // afronding van de float-tabel na.
+    static int symbolIndex(char c) {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a';
+        if (c >= '0' && c <= '9') return 26 + (c - '0');
+        return -1;
+    }
+
+    // Tekst naar symboolindices; andere tekens vallen weg (zoals in score_strict).
+    static std::vector<uint8_t> symbolIndices(const std::string& text) {
+        std::vector<uint8_t> symbols;
+        symbols.reserve(text.size());
+        for (char c : text) {
+            int s = symbolIndex(c);
+            if (s >= 0) symbols.push_back(static_cast<uint8_t>(s));
+        }
+        return symbols;
+    }
+
+    // Quadgrams met een cijfer tellen niet mee.
+    double scoreSymbolsTolerant(const uint8_t* symbols, size_t n) const {
+        if (n < 4) return floor_prob * 4.0;
+        const float* table = placed_table.local(letter_table.data());
+        double total_score = 0.0;
+        for (size_t i = 0; i + 3 < n; ++i) {
+            if (symbols[i] >= 26 || symbols[i + 1] >= 26 || symbols[i + 2] >= 26 || symbols[i + 3] >= 26) continue;
+            size_t index = ((symbols[i] * 26 + symbols[i + 1]) * 26 + symbols[i + 2]) * 26 + symbols[i + 3];
+            total_score += table[index];
+        }
+        return total_score;
+    }
+
+    // Quadgrams met een cijfer krijgen de bodemscore.
+    double scoreSymbolsStrict(const uint8_t* symbols, size_t n) const {
+        if (n < 4) return floor_prob * 4.0;
+        const float* table = placed_table.local(letter_table.data());
+        const double floor = static_cast<float>(floor_prob);
+        double total_score = 0.0;
+        for (size_t i = 0; i + 3 < n; ++i) {
+            if (symbols[i] >= 26 || symbols[i + 1] >= 26 || symbols[i + 2] >= 26 || symbols[i + 3] >= 26) {
+                total_score += floor;
+                continue;
+            }
+            size_t index = ((symbols[i] * 26 + symbols[i + 1]) * 26 + symbols[i + 2]) * 26 + symbols[i + 3];
+            total_score += table[index];
+        }
+        return total_score;
+    }
+
+    // Vóór het starten van de threads oproepen; de gewone vector blijft de bron (letterTable).
+    void placeTable(const TablePlacement& placement) {
+        if (placement.enabled()) placed_table.place(letter_table, placement);
+    }
+    std::string describeTablePlacement() const { return placed_table.describe(); }
+
+    float letterQuadgram(size_t index) const { return letter_table[index]; }
+    const std::vector<float>& letterTable() const { return letter_table; }
+    double floorProbability() const { return floor_prob; }
+
+    // Letterfrequenties (0..1) afgeleid uit de eerste letter van elke quadgram.
+    const double* letterFrequencies() const { return letter_frequencies; }
+
+private:
+    std::map<std::string, double> log_probabilities;
+    double floor_prob;
+    std::vector<float> letter_table;
+    PlacedTable<float> placed_table;
+    double letter_frequencies[26]{};
+};
+
+#endif // COMMON_QUADGRAMSCORER_H
@@ -0,0 +1,111 @@
+#ifndef COMMON_RANDOM_H
+#define COMMON_RANDOM_H
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <utility>
+
+// Snelle, reproduceerbare random-generator voor alle solvers: xoshiro256** (Blackman & Vigna),
+// 256 bits toestand, vier shifts/rotaties per getal. Voldoet aan UniformRandomBitGenerator,
+// maar trek liever via below() en unit(): die zijn zuiver en hangen niet af van de
+// implementatie van std::uniform_*_distribution, dus dezelfde seed geeft overal dezelfde reeks.
+//
+// Opsplitsen in onafhankelijke stromen:
+//   Rng(seed, stream)   een eigen stroom per werkeenheid (bv. per permutatie of per run);
+//                       zo hangt het resultaat niet af van welke thread de eenheid oppikt.
+//   jump()              2^128 stappen vooruit (disjuncte stromen uit één generator).
+class Rng {
+public:
+    using result_type = uint64_t;
+
+    explicit Rng(uint64_t seed = 0, uint64_t stream = 0) {
+        // splitmix64 vult de toestand; de stroom wordt eerst door elkaar gehusseld zodat
+        // naburige (seed, stream)-paren niet op elkaar lijken.
+        uint64_t x = seed ^ mix(stream + 0x9E3779B97F4A7C15ULL);
+        for (uint64_t& word : s) word = splitmix(x);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<uint64_t>::max(); }
+
+    uint64_t operator()() {
+        const uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, n), zonder modulo-bias (Lemire): de bovenste 32 bits van een trekking maal n
+    // geeft een 32x32->64 product, waarvan de hoge helft het resultaat is; enkel als de lage helft
+    // onder 2^32 mod n valt, wordt (zelden) opnieuw getrokken. n moet > 0 zijn.
+    uint32_t below(uint32_t n) {
+        uint64_t m = static_cast<uint64_t>(static_cast<uint32_t>((*this)() >> 32)) * n;
+        uint32_t low = static_cast<uint32_t>(m);
+        if (low < n) {
+            const uint32_t threshold = static_cast<uint32_t>(-n) % n;
+            while (low < threshold) {
+                m = static_cast<uint64_t>(static_cast<uint32_t>((*this)() >> 32)) * n;
+                low = static_cast<uint32_t>(m);
+            }
+        }
+        return static_cast<uint32_t>(m >> 32);
+    }
+
+    // Uniform in [0, 1) met 53 bits precisie.
+    double unit() { return static_cast<double>((*this)() >> 11) * 0x1.0p-53; }
+
+    // Fisher-Yates met below(); std::shuffle geeft per standaardbibliotheek een andere volgorde.
+    template <typename Container>
+    void shuffle(Container& items) {
+        for (size_t i = items.size(); i > 1; --i) {
+            std::swap(items[i - 1], items[below(static_cast<uint32_t>(i))]);
+        }
+    }
+
+    // Gelijk aan 2^128 oproepen van operator().
+    void jump() {
+        static constexpr uint64_t JUMP[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                            0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+        uint64_t next[4] = {};
+        for (uint64_t word : JUMP) {
+            for (int bit = 0; bit < 64; ++bit) {
+                if (word & (uint64_t{1} << bit)) {
+                    for (int i = 0; i < 4; ++i) next[i] ^= s[i];
+                }
+                (*this)();
+            }
+        }
+        for (int i = 0; i < 4; ++i) s[i] = next[i];
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    static uint64_t splitmix(uint64_t& x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        return mix(x);
+    }
+
+    uint64_t s[4];
+};
+
+// Seed voor wanneer de gebruiker er geen meegeeft; de solvers drukken hem af zodat de run
+// met --seed herhaald kan worden.
+inline uint64_t randomSeed() {
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) | device();
+}
+
+#endif // COMMON_RANDOM_H
@@ -0,0 +1,374 @@
+#ifndef COMMON_RESULTRECORD_H
+#define COMMON_RESULTRECORD_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "JsonLine.h"
+
+// Gestructureerd resultaat van één solverrun (--results PREFIX): de top-K sleutels met hun score,
+// de plaintext van de beste, en de runstatistieken. Zo kan een pipeline de tweede of derde
+// kandidaat oppikken zonder de console-log te parsen of de zoektocht over te doen.
+//
+// Elke record gaat naar twee bestanden, allebei in append-modus:
+//   PREFIX.jsonl  één plat JSON-object per run (common/JsonLine.h kent geen arrays, dus de
+//                 kandidaten zijn genummerd: key_1, score_1, plaintext_1, key_2, ...);
+//   PREFIX.bin    dezelfde record compact binair (zie encode), te lezen met readResultFile of
+//                 om te zetten met bench/result_dump.
+
+struct ResultCandidate {
+    double score = 0.0;
+    std::string key;            // zoals de solver hem toont, bv. de 25 letters van een Playfair-vierkant
+    std::string plaintext;      // leeg als de solver hem niet goedkoop kan maken
+};
+
+// Solverspecifiek veld van een record. Getallen blijven getallen, zodat ze in de JSON-regel
+// als JSON-getal staan en binair als varint of double.
+struct ResultInfo {
+    enum class Kind : uint8_t { Text = 0, Integer = 1, Real = 2 };
+
+    std::string key;
+    Kind kind = Kind::Text;
+    std::string text;
+    int64_t integer = 0;
+    double real = 0.0;
+};
+
+struct ResultRecord {
+    std::string solver;                         // programmanaam, bv. "playfair_cracker"
+    std::string status = "finished";            // finished, solved, timeout, cancelled, interim of merged
+    std::string model;
+    std::string input;                          // ciphertextbestand(en)
+    std::optional<uint64_t> seed;               // leeg voor deterministische zoektochten
+    uint64_t iterations = 0;
+    double seconds = 0.0;
+    std::vector<ResultCandidate> top;           // beste eerst
+    std::vector<ResultInfo> info;               // solverspecifiek, bv. de transpositie
+
+    double iterationsPerSecond() const { return seconds > 0.0 ? iterations / seconds : 0.0; }
+
+    ResultRecord& addInfo(const std::string& key, const std::string& value) {
+        ResultInfo field;
+        field.key = key;
+        field.text = value;
+        info.push_back(std::move(field));
+        return *this;
+    }
+    ResultRecord& addInfo(const std::string& key, const char* value) { return addInfo(key, std::string(value)); }
+    ResultRecord& addInfo(const std::string& key, double value) {
+        ResultInfo field;
+        field.key = key;
+        field.kind = ResultInfo::Kind::Real;
+        field.real = value;
+        info.push_back(std::move(field));
+        return *this;
+    }
+    template <typename Integer, typename = std::enable_if_t<std::is_integral_v<Integer>>>
+    ResultRecord& addInfo(const std::string& key, Integer value) {
+        ResultInfo field;
+        field.key = key;
+        field.kind = ResultInfo::Kind::Integer;
+        field.integer = static_cast<int64_t>(value);
+        info.push_back(std::move(field));
+        return *this;
+    }
+
+    JsonObject toJson() const {
+        JsonObject json;
+        json.set("solver", solver).set("status", status).set("model", model).set("input", input);
+        if (seed) json.set("seed", *seed);
+        json.set("iterations", iterations).set("seconds", seconds).set("iterations_per_second", iterationsPerSecond());
+        for (const auto& field : info) {
+            switch (field.kind) {
+                case ResultInfo::Kind::Text: json.set(field.key, field.text); break;
+                case ResultInfo::Kind::Integer: json.set(field.key, field.integer); break;
+                case ResultInfo::Kind::Real: json.set(field.key, field.real); break;
+            }
+        }
+        json.set("top_count", top.size());
+        for (size_t i = 0; i < top.size(); ++i) {
+            std::string n = std::to_string(i + 1);
+            json.set("score_" + n, top[i].score).set("key_" + n, top[i].key);
+            if (!top[i].plaintext.empty()) json.set("plaintext_" + n, top[i].plaintext);
+        }
+        return json;
+    }
+
+    // Binair: "CTR" + versie, de lengte van de rest als varint, en dan de velden in vaste volgorde.
+    // Gehele getallen als varint (LEB128), scores en tijden als 8-byte little-endian double,
+    // strings als varint-lengte + bytes. Dankzij de lengte kan een lezer records overslaan.
+    // Een infoveld is de sleutel, een typebyte (ResultInfo::Kind) en de waarde: string, geheel getal
+    // als zigzag-varint of double. Versie 1 kende enkel strings en wordt nog gelezen.
+    std::string encode() const {
+        std::string body;
+        putString(body, solver);
+        putString(body, status);
+        putString(body, model);
+        putString(body, input);
+        body += static_cast<char>(seed ? 1 : 0);
+        if (seed) putVarint(body, *seed);
+        putVarint(body, iterations);
+        putDouble(body, seconds);
+        putVarint(body, info.size());
+        for (const auto& field : info) {
+            putString(body, field.key);
+            body += static_cast<char>(field.kind);
+            switch (field.kind) {
+                case ResultInfo::Kind::Text: putString(body, field.text); break;
+                case ResultInfo::Kind::Integer: putVarint(body, zigzag(field.integer)); break;
+                case ResultInfo::Kind::Real: putDouble(body, field.real); break;
+            }
+        }
+        putVarint(body, top.size());
+        for (const auto& candidate : top) {
+            putDouble(body, candidate.score);
+            putString(body, candidate.key);
+            putString(body, candidate.plaintext);
+        }
+        std::string out(MAGIC, sizeof(MAGIC));
+        putVarint(out, body.size());
+        return out + body;
+    }
+
+    // Leest de record die begint op 'pos' en zet 'pos' erachter.
+    static ResultRecord decode(const std::string& data, size_t& pos) {
+        if (data.compare(pos, 3, MAGIC, 3) != 0 || pos + 3 >= data.size() ||
+            (data[pos + 3] != 1 && data[pos + 3] != MAGIC[3])) {
+            throw std::runtime_error("Resultaatbestand: onbekend formaat of versie op positie " + std::to_string(pos));
+        }
+        bool typed_info = data[pos + 3] != 1;
+        pos += sizeof(MAGIC);
+        uint64_t length = getVarint(data, pos);
+        if (length > data.size() - pos) throw std::runtime_error("Resultaatbestand: afgekapte record");
+        size_t end = pos + length;
+
+        ResultRecord record;
+        record.solver = getString(data, pos, end);
+        record.status = getString(data, pos, end);
+        record.model = getString(data, pos, end);
+        record.input = getString(data, pos, end);
+        need(pos, 1, end);
+        if (data[pos++]) record.seed = getVarint(data, pos, end);
+        record.iterations = getVarint(data, pos, end);
+        record.seconds = getDouble(data, pos, end);
+        for (uint64_t n = getVarint(data, pos, end); n > 0; --n) {
+            ResultInfo field;
+            field.key = getString(data, pos, end);
+            if (typed_info) {
+                need(pos, 1, end);
+                uint8_t kind = static_cast<uint8_t>(data[pos++]);
+                if (kind > static_cast<uint8_t>(ResultInfo::Kind::Real)) {
+                    throw std::runtime_error("Resultaatbestand: onbekend type voor veld " + field.key);
+                }
+                field.kind = static_cast<ResultInfo::Kind>(kind);
+            }
+            switch (field.kind) {
+                case ResultInfo::Kind::Text: field.text = getString(data, pos, end); break;
+                case ResultInfo::Kind::Integer: field.integer = unzigzag(getVarint(data, pos, end)); break;
+                case ResultInfo::Kind::Real: field.real = getDouble(data, pos, end); break;
+            }
+            record.info.push_back(std::move(field));
+        }
+        for (uint64_t n = getVarint(data, pos, end); n > 0; --n) {
+            ResultCandidate candidate;
+            candidate.score = getDouble(data, pos, end);
+            candidate.key = getString(data, pos, end);
+            candidate.plaintext = getString(data, pos, end);
+            record.top.push_back(std::move(candidate));
+        }
+        pos = end;
+        return record;
+    }
+
+private:
+    static constexpr char MAGIC[4] = {'C', 'T', 'R', 2};
+
+    static uint64_t zigzag(int64_t value) { return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63); }
+    static int64_t unzigzag(uint64_t value) { return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1); }
+
+    static void putVarint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out += static_cast<char>(0x80 | (value & 0x7F));
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    static void putDouble(std::string& out, double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int b = 0; b < 8; ++b) out += static_cast<char>(bits >> (8 * b));
+    }
+
+    static void putString(std::string& out, const std::string& text) {
+        putVarint(out, text.size());
+        out += text;
+    }
+
+    static void need(size_t pos, size_t bytes, size_t end) {
+        if (pos > end || bytes > end - pos) throw std::runtime_error("Resultaatbestand: afgekapte record");
+    }
+
+    static uint64_t getVarint(const std::string& data, size_t& pos, size_t end = std::string::npos) {
+        end = std::min(end, data.size());
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            need(pos, 1, end);
+            uint8_t byte = static_cast<uint8_t>(data[pos++]);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        throw std::runtime_error("Resultaatbestand: ongeldige varint");
+    }
+
+    static double getDouble(const std::string& data, size_t& pos, size_t end) {
+        need(pos, 8, end);
+        uint64_t bits = 0;
+        for (int b = 0; b < 8; ++b) bits |= static_cast<uint64_t>(static_cast<uint8_t>(data[pos++])) << (8 * b);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    static std::string getString(const std::string& data, size_t& pos, size_t end) {
+        uint64_t length = getVarint(data, pos, end);
+        need(pos, length, end);
+        std::string text = data.substr(pos, length);
+        pos += length;
+        return text;
+    }
+};
+
+// Een permutatie- of transpositiesleutel als tekst, zoals in best_transpo_key.txt: "4 0 6 2 1 3 5".
+inline std::string keyText(const std::vector<int>& key) {
+    std::string text;
+    for (size_t i = 0; i < key.size(); ++i) text += (i ? " " : "") + std::to_string(key[i]);
+    return text;
+}
+
+inline std::vector<ResultRecord> readResultFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("Kon resultaatbestand niet openen: " + path);
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::vector<ResultRecord> records;
+    for (size_t pos = 0; pos < data.size();) records.push_back(ResultRecord::decode(data, pos));
+    return records;
+}
+
+// Top-K van verschillende sleutels. Solvers met één annealer geven elk nieuw record door: omdat een
+// record altijd beter is dan het vorige, zijn dat de laatste K records, de eerdere lokale optima
+// waar de zoektocht langs kwam. anneal_solver geeft het resultaat van elke run door.
+class ResultCandidates {
+public:
+    explicit ResultCandidates(size_t k = 10) : k(k) {}
+
+    void add(double score, const std::string& key, const std::string& plaintext = "") {
+        if (k == 0) return;
+        for (auto& candidate : items) {
+            if (candidate.key != key) continue;
+            if (score > candidate.score) candidate = {score, key, plaintext};
+            sortItems();
+            return;
+        }
+        if (items.size() == k && score <= items.back().score) return;
+        items.push_back({score, key, plaintext});
+        sortItems();
+        if (items.size() > k) items.pop_back();
+    }
+
+    size_t capacity() const { return k; }
+    const std::vector<ResultCandidate>& ranked() const { return items; }
+
+private:
+    size_t k;
+    std::vector<ResultCandidate> items;
+
+    void sortItems() {
+        std::stable_sort(items.begin(), items.end(),
+                         [](const ResultCandidate& a, const ResultCandidate& b) { return a.score > b.score; });
+    }
+};
+
+// Schrijft records weg op een eigen thread: submit verplaatst de record enkel in een wachtrij,
+// zodat een zoekthread nooit op de schijf wacht. De bestanden hebben een grote buffer en worden
+// pas geflusht als de wachtrij leeg is; de destructor schrijft alles wat nog wacht.
+class ResultWriter {
+public:
+    explicit ResultWriter(const std::string& prefix) : json_path(prefix + ".jsonl"), binary_path(prefix + ".bin") {
+        json.rdbuf()->pubsetbuf(json_buffer, sizeof(json_buffer));
+        binary.rdbuf()->pubsetbuf(binary_buffer, sizeof(binary_buffer));
+        json.open(json_path, std::ios::app);
+        binary.open(binary_path, std::ios::app | std::ios::binary);
+        if (!json || !binary) throw std::runtime_error("Kon resultaatbestanden niet openen: " + prefix + ".{jsonl,bin}");
+        worker = std::thread(&ResultWriter::run, this);
+    }
+
+    ~ResultWriter() {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            closing = true;
+        }
+        changed.notify_one();
+        worker.join();
+    }
+
+    ResultWriter(const ResultWriter&) = delete;
+    ResultWriter& operator=(const ResultWriter&) = delete;
+
+    void submit(ResultRecord record) {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            queue.push_back(std::move(record));
+        }
+        changed.notify_one();
+    }
+
+    const std::string& jsonPath() const { return json_path; }
+    const std::string& binaryPath() const { return binary_path; }
+
+private:
+    std::string json_path;
+    std::string binary_path;
+    char json_buffer[1 << 16];
+    char binary_buffer[1 << 16];
+    std::ofstream json;
+    std::ofstream binary;
+
+    std::mutex m;
+    std::condition_variable changed;
+    std::deque<ResultRecord> queue;
+    bool closing = false;
+    std::thread worker;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(m);
+        while (true) {
+            changed.wait(lock, [this] { return closing || !queue.empty(); });
+            if (queue.empty()) return;
+            std::deque<ResultRecord> batch;
+            batch.swap(queue);
+            lock.unlock();
+            for (const ResultRecord& record : batch) {
+                json << record.toJson().dump() << '\n';
+                binary << record.encode();
+            }
+            json.flush();
+            binary.flush();
+            lock.lock();
+        }
+    }
+};
+
+#endif // COMMON_RESULTRECORD_H
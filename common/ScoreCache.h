@@ -0,0 +1,128 @@
+#ifndef COMMON_SCORECACHE_H
+#define COMMON_SCORECACHE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Random.h"
+
+// Optionele geheugen-cache sleutel -> score voor de annealing-lus (common/Anneal.h).
+// Bij lage temperatuur stelt de annealer steeds dezelfde buren van de huidige sleutel voor
+// (dezelfde swap opnieuw, of de zet die de vorige ongedaan maakt); met de cache kosten die
+// een tabelopzoeking in plaats van een volledige decrypt + quadgramscore.
+//
+// De sleutel wordt herkend aan een Zobrist-hash: XOR van een vast random getal per
+// (positie, symbool). Een swap van twee posities verandert de hash met vier XOR's, zodat
+// de mutator hem per zet bijwerkt (hashDelta) zonder de sleutel opnieuw te hashen.
+
+// Zobrist-getallen voor sleutels van hoogstens CELLS posities met symbolen A-Z en 0-9.
+// Symbool c gebruikt rij c & 63: A-Z vallen op 1-26 en 0-9 op 48-57, dus allemaal verschillend.
+struct ZobristTable {
+    static constexpr int CELLS = 36;
+    static constexpr int SYMBOLS = 64;
+    uint64_t value[CELLS][SYMBOLS];
+
+    ZobristTable() {
+        Rng rng(0x5A0B215755ULL);              // vast: dezelfde hashes in elke run
+        for (auto& cell : value) {
+            for (uint64_t& v : cell) v = rng();
+        }
+    }
+
+    uint64_t operator()(int cell, char symbol) const { return value[cell][static_cast<unsigned char>(symbol) & 63]; }
+
+    template <typename State>
+    uint64_t hash(const State& state) const {
+        uint64_t h = 0;
+        for (size_t i = 0; i < state.size(); ++i) h ^= (*this)(static_cast<int>(i), state[i]);
+        return h;
+    }
+};
+
+inline const ZobristTable& zobristTable() {
+    static const ZobristTable table;
+    return table;
+}
+
+// Tellers per annealer; op te tellen over threads zoals AnnealProfile.
+struct ScoreCacheStats {
+    uint64_t lookups = 0;
+    uint64_t hits = 0;
+    uint64_t timed_misses = 0;                 // elke TIME_EVERY-de misser wordt getimed
+    double timed_miss_seconds = 0.0;
+
+    static constexpr uint64_t TIME_EVERY = 64;
+
+    double hitRate() const { return lookups ? double(hits) / lookups : 0.0; }
+    // Geschatte bespaarde tijd: elke hit spaart een gemiddelde misser uit (decrypt + score).
+    double secondsSaved() const { return timed_misses ? hits * timed_miss_seconds / timed_misses : 0.0; }
+
+    ScoreCacheStats& operator+=(const ScoreCacheStats& other) {
+        lookups += other.lookups;
+        hits += other.hits;
+        timed_misses += other.timed_misses;
+        timed_miss_seconds += other.timed_miss_seconds;
+        return *this;
+    }
+};
+
+// Eén regel voor de eindrapportage van de solvers.
+inline std::string describeScoreCache(const ScoreCacheStats& stats, size_t bytes) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << "Score-cache (" << bytes / 1024 << " KiB): "
+        << 100.0 * stats.hitRate() << "% hits (" << stats.hits << " van " << stats.lookups << "), ~"
+        << std::setprecision(2) << stats.secondsSaved() << " s decrypt+score bespaard";
+    return out.str();
+}
+
+// Vaste grootte (2^bits vakjes), direct gemapt en verliesgevend: een nieuwe sleutel overschrijft
+// wat er in zijn vakje stond. Eén cache per annealer, dus per thread; er is geen locking.
+class ScoreCache {
+public:
+    static constexpr int MAX_BITS = 26;
+
+    ScoreCache() = default;
+    explicit ScoreCache(int bits) {
+        if (bits < 1 || bits > MAX_BITS) {
+            throw std::invalid_argument("ScoreCache: bits moet tussen 1 en " + std::to_string(MAX_BITS) + " liggen.");
+        }
+        slots.assign(size_t{1} << bits, Slot{});
+        mask = slots.size() - 1;
+    }
+
+    bool enabled() const { return !slots.empty(); }
+    size_t bytes() const { return slots.size() * sizeof(Slot); }
+    static size_t bytesFor(int bits) { return sizeof(Slot) << bits; }
+
+    // Hash 0 is het lege vakje; een echte sleutel met hash 0 wordt gewoon nooit gevonden.
+    bool lookup(uint64_t hash, double& score) {
+        stats.lookups++;
+        const Slot& slot = slots[hash & mask];
+        if (slot.hash != hash || hash == 0) return false;
+        stats.hits++;
+        score = slot.score;
+        return true;
+    }
+
+    void store(uint64_t hash, double score) { slots[hash & mask] = Slot{hash, score}; }
+
+    void clear() { std::fill(slots.begin(), slots.end(), Slot{}); }
+
+    ScoreCacheStats stats;
+
+private:
+    struct Slot {
+        uint64_t hash = 0;
+        double score = 0.0;
+    };
+
+    std::vector<Slot> slots;
+    size_t mask = 0;
+};
+
+#endif // COMMON_SCORECACHE_H
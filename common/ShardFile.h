@@ -0,0 +1,321 @@
+#ifndef COMMON_SHARDFILE_H
+#define COMMON_SHARDFILE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstdio>
+
+// --- Sharding van een sleutelruimte over meerdere processen/machines ---
+// Elke shard krijgt een vast, aaneengesloten stuk van de (gerangschikte) sleutelruimte,
+// verdeelt dat in blokken en schrijft na elk afgewerkt blok een klein resultaatbestand weg.
+// Een herstarte shard leest dat bestand en slaat de afgewerkte blokken over.
+
+struct ShardCandidate {
+    double score;
+    std::vector<int> key;
+};
+
+// Deterministische rangorde: hoogste score eerst, bij gelijke score de lexicografisch kleinste sleutel.
+// Zo geeft het samenvoegen van shards exact dezelfde ranking als een run in één proces.
+inline bool rankedBefore(const ShardCandidate& a, const ShardCandidate& b) {
+    if (a.score != b.score) return a.score > b.score;
+    return a.key < b.key;
+}
+
+// Begrensde top-K lijst, altijd gesorteerd volgens rankedBefore.
+class TopK {
+public:
+    explicit TopK(size_t k = 10) : k(k) {}
+
+    void add(const ShardCandidate& candidate) {
+        if (k == 0) return;
+        if (items.size() == k && !rankedBefore(candidate, items.back())) return;
+        auto pos = std::upper_bound(items.begin(), items.end(), candidate, rankedBefore);
+        items.insert(pos, candidate);
+        if (items.size() > k) items.pop_back();
+    }
+
+    void merge(const TopK& other) {
+        for (const auto& c : other.items) add(c);
+    }
+
+    size_t capacity() const { return k; }
+    void setCapacity(size_t new_k) {
+        k = new_k;
+        if (items.size() > k) items.resize(k);
+    }
+    const std::vector<ShardCandidate>& ranked() const { return items; }
+
+private:
+    size_t k;
+    std::vector<ShardCandidate> items;
+};
+
+struct ShardSpec {
+    uint64_t index = 0;
+    uint64_t count = 1;
+};
+
+// Parseert "i/N" met 0 <= i < N.
+inline ShardSpec parseShardSpec(const std::string& text) {
+    ShardSpec spec;
+    size_t slash = text.find('/');
+    try {
+        if (slash == std::string::npos) throw std::invalid_argument(text);
+        spec.index = std::stoull(text.substr(0, slash));
+        spec.count = std::stoull(text.substr(slash + 1));
+    } catch (const std::exception&) {
+        throw std::invalid_argument("Ongeldige shard-specificatie '" + text + "' (verwacht i/N).");
+    }
+    if (spec.count == 0 || spec.index >= spec.count) {
+        throw std::invalid_argument("Ongeldige shard-specificatie '" + text + "' (vereist 0 <= i < N).");
+    }
+    return spec;
+}
+
+struct ShardState {
+    std::string solver;
+    ShardSpec shard;
+    uint64_t range_begin = 0;   // eerste globale rang van deze shard
+    uint64_t range_end = 0;     // één voorbij de laatste rang
+    uint64_t block_size = 1;
+    // Alles wat de scores bepaalt (invoer, model, iteraties, seed, ...), als één regel tekst; zie
+    // sameShardSettings. Blokken uit runs met andere instellingen mogen niet samengevoegd worden.
+    std::string settings;
+    std::vector<bool> done_blocks;
+    double elapsed_seconds = 0.0;
+    std::map<std::string, uint64_t> counters;
+    TopK top;
+
+    uint64_t numBlocks() const { return done_blocks.size(); }
+
+    // Globale rangen [first, second) van blok b.
+    std::pair<uint64_t, uint64_t> blockRange(uint64_t b) const {
+        uint64_t begin = range_begin + b * block_size;
+        return {begin, std::min(range_end, begin + block_size)};
+    }
+
+    bool complete() const {
+        return std::all_of(done_blocks.begin(), done_blocks.end(), [](bool d) { return d; });
+    }
+};
+
+// Korte vingerafdruk van een tekst (FNV-1a, 64 bit, hexadecimaal) voor ShardState::settings:
+// de ciphertext zelf hoort niet in het shard-bestand, maar een ander bericht moet wel opvallen.
+inline std::string textFingerprint(const std::string& text) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    std::ostringstream out;
+    out << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return out.str();
+}
+
+// Verse toestand voor shard `spec` van een sleutelruimte met `keyspace_size` elementen.
+// Met block_aligned krijgt elke shard hele blokken (op globale veelvouden van block_size), zodat een
+// blok in elke shard-indeling dezelfde rangen bevat; nodig als de blokken iets delen, zoals de warme
+// starts van find_transposition. Een shard kan dan leeg zijn als er minder blokken dan shards zijn.
+inline ShardState newShardState(const std::string& solver, uint64_t keyspace_size, const ShardSpec& spec,
+                                uint64_t block_size, size_t top_k, bool block_aligned = false) {
+    ShardState state;
+    state.solver = solver;
+    state.shard = spec;
+    state.block_size = std::max<uint64_t>(1, block_size);
+    uint64_t unit = block_aligned ? state.block_size : 1;
+    uint64_t units = (keyspace_size + unit - 1) / unit;
+    uint64_t first = units / spec.count * spec.index + std::min(spec.index, units % spec.count);
+    uint64_t last = first + units / spec.count + (spec.index < units % spec.count ? 1 : 0);
+    state.range_begin = std::min(keyspace_size, first * unit);
+    state.range_end = std::min(keyspace_size, last * unit);
+    uint64_t size = state.range_end - state.range_begin;
+    state.done_blocks.assign((size + state.block_size - 1) / state.block_size, false);
+    state.top = TopK(top_k);
+    return state;
+}
+
+// Schrijft atomair weg (eerst naar .tmp, dan rename), zodat een crash nooit een half bestand achterlaat.
+inline void saveShardState(const ShardState& state, const std::string& path) {
+    std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream out(tmp_path);
+        if (!out.is_open()) {
+            throw std::runtime_error("Kon shard-bestand niet schrijven: " + tmp_path);
+        }
+        out << "# codetheorie-shard v1\n";
+        out << "solver " << state.solver << "\n";
+        out << "shard " << state.shard.index << "/" << state.shard.count << "\n";
+        out << "range " << state.range_begin << " " << state.range_end << "\n";
+        out << "block_size " << state.block_size << "\n";
+        if (!state.settings.empty()) out << "settings " << state.settings << "\n";
+
+        // Afgewerkte blokken als reeksen "a-b", compact voor lange runs.
+        out << "done";
+        for (uint64_t b = 0; b < state.numBlocks();) {
+            if (!state.done_blocks[b]) { ++b; continue; }
+            uint64_t e = b;
+            while (e + 1 < state.numBlocks() && state.done_blocks[e + 1]) ++e;
+            out << " " << b;
+            if (e > b) out << "-" << e;
+            b = e + 1;
+        }
+        out << "\n";
+
+        out << std::setprecision(17);
+        out << "elapsed_seconds " << state.elapsed_seconds << "\n";
+        for (const auto& [name, value] : state.counters) {
+            out << "counter " << name << " " << value << "\n";
+        }
+        out << "top_k " << state.top.capacity() << "\n";
+        for (const auto& c : state.top.ranked()) {
+            out << "candidate " << c.score;
+            for (int k : c.key) out << " " << k;
+            out << "\n";
+        }
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Kon shard-bestand niet hernoemen naar: " + path);
+    }
+}
+
+// Leest een shard-bestand in. Geeft false terug als het bestand niet bestaat.
+inline bool loadShardState(const std::string& path, ShardState& state) {
+    std::ifstream in(path);
+    if (!in.is_open()) return false;
+
+    state = ShardState();
+    std::string line;
+    std::string done_line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream ls(line);
+        std::string tag;
+        ls >> tag;
+        if (tag == "solver") {
+            ls >> state.solver;
+        } else if (tag == "shard") {
+            std::string spec;
+            ls >> spec;
+            state.shard = parseShardSpec(spec);
+        } else if (tag == "range") {
+            ls >> state.range_begin >> state.range_end;
+        } else if (tag == "block_size") {
+            ls >> state.block_size;
+        } else if (tag == "settings") {
+            state.settings = line.size() > 9 ? line.substr(9) : "";
+        } else if (tag == "done") {
+            done_line = line.substr(4);
+        } else if (tag == "elapsed_seconds") {
+            ls >> state.elapsed_seconds;
+        } else if (tag == "counter") {
+            std::string name;
+            uint64_t value = 0;
+            ls >> name >> value;
+            state.counters[name] = value;
+        } else if (tag == "top_k") {
+            size_t k = 0;
+            ls >> k;
+            state.top.setCapacity(k);
+        } else if (tag == "candidate") {
+            ShardCandidate c;
+            ls >> c.score;
+            int k;
+            while (ls >> k) c.key.push_back(k);
+            state.top.add(c);
+        } else {
+            throw std::runtime_error("Onbekende regel in shard-bestand " + path + ": " + line);
+        }
+    }
+
+    if (state.block_size == 0 || state.range_end < state.range_begin) {
+        throw std::runtime_error("Corrupt shard-bestand: " + path);
+    }
+    uint64_t size = state.range_end - state.range_begin;
+    state.done_blocks.assign((size + state.block_size - 1) / state.block_size, false);
+
+    std::istringstream ds(done_line);
+    std::string run;
+    while (ds >> run) {
+        size_t dash = run.find('-');
+        uint64_t a = std::stoull(run.substr(0, dash));
+        uint64_t b = dash == std::string::npos ? a : std::stoull(run.substr(dash + 1));
+        for (uint64_t i = a; i <= b && i < state.numBlocks(); ++i) state.done_blocks[i] = true;
+    }
+    return true;
+}
+
+// Controleert of een ingelezen bestand bij dezelfde shard-configuratie hoort (nodig om te hervatten).
+inline bool sameShardLayout(const ShardState& a, const ShardState& b) {
+    return a.solver == b.solver && a.shard.index == b.shard.index && a.shard.count == b.shard.count &&
+           a.range_begin == b.range_begin && a.range_end == b.range_end && a.block_size == b.block_size;
+}
+
+// Controleert of een ingelezen bestand met dezelfde instellingen gemaakt is. Bestanden van vóór de
+// instellingenregel hebben een lege 'settings' en passen dus bij geen enkele run met instellingen.
+inline bool sameShardSettings(const ShardState& a, const ShardState& b) { return a.settings == b.settings; }
+
+// Foutmelding voor een shard-bestand dat niet bij deze run hoort (voor hervatten en --merge).
+inline std::string settingsMismatch(const std::string& path, const std::string& found, const std::string& expected,
+                                    const std::string& expected_label = "deze run") {
+    return "Shard-bestand " + path + " is gemaakt met andere instellingen.\n  bestand:  " +
+           (found.empty() ? "(geen)" : found) + "\n  " + expected_label + ": " + (expected.empty() ? "(geen)" : expected);
+}
+
+// Resultaat van het samenvoegen van meerdere shard-bestanden.
+struct MergedShards {
+    TopK top;
+    std::map<std::string, uint64_t> counters;
+    double total_seconds = 0.0;       // som over alle shards (rekentijd)
+    double slowest_shard_seconds = 0.0;
+    uint64_t shards_seen = 0;
+    uint64_t shard_count = 0;
+    uint64_t incomplete_shards = 0;
+    std::string settings;             // gelijk voor alle shards
+};
+
+inline MergedShards mergeShardFiles(const std::vector<std::string>& paths, const std::string& expected_solver) {
+    MergedShards merged;
+    std::vector<bool> seen;
+    for (const auto& path : paths) {
+        ShardState state;
+        if (!loadShardState(path, state)) {
+            throw std::runtime_error("Kon shard-bestand niet openen: " + path);
+        }
+        if (state.solver != expected_solver) {
+            throw std::runtime_error("Shard-bestand " + path + " hoort bij '" + state.solver + "', niet bij '" + expected_solver + "'.");
+        }
+        if (merged.shard_count == 0) {
+            merged.shard_count = state.shard.count;
+            seen.assign(merged.shard_count, false);
+            merged.top.setCapacity(state.top.capacity());
+            merged.settings = state.settings;
+        } else if (state.shard.count != merged.shard_count) {
+            throw std::runtime_error("Shard-bestanden met verschillende N kunnen niet samengevoegd worden: " + path);
+        } else if (state.settings != merged.settings) {
+            throw std::runtime_error(settingsMismatch(path, state.settings, merged.settings, "1e shard"));
+        }
+        if (seen[state.shard.index]) {
+            throw std::runtime_error("Shard " + std::to_string(state.shard.index) + " komt dubbel voor: " + path);
+        }
+        seen[state.shard.index] = true;
+        merged.shards_seen++;
+        if (!state.complete()) merged.incomplete_shards++;
+
+        merged.top.setCapacity(std::max(merged.top.capacity(), state.top.capacity()));
+        merged.top.merge(state.top);
+        for (const auto& [name, value] : state.counters) merged.counters[name] += value;
+        merged.total_seconds += state.elapsed_seconds;
+        merged.slowest_shard_seconds = std::max(merged.slowest_shard_seconds, state.elapsed_seconds);
+    }
+    return merged;
+}
+
+#endif // COMMON_SHARDFILE_H
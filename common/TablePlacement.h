@@ -0,0 +1,342 @@
+#ifndef COMMON_TABLEPLACEMENT_H
+#define COMMON_TABLEPLACEMENT_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Plaatsing van grote, alleen-lezen scoretabellen (de 26^4-quadgramtabel: 1,7 MiB) voor machines
+// met veel kernen. Twee onafhankelijke opties:
+//
+//   huge pages  2 MiB-pagina's in plaats van 4 KiB: de tabel past dan in één TLB-entry in plaats
+//               van ~450, zodat willekeurige opzoekingen geen page walks meer kosten.
+//                 thp       transparent huge pages via madvise (werkt als
+//                           /sys/kernel/mm/transparent_hugepage/enabled op always of madvise staat);
+//                 explicit  uit de gereserveerde pool (vm.nr_hugepages) met MAP_HUGETLB.
+//   NUMA        een kopie per geheugenknoop (mbind vóór de eerste schrijf), en elke thread leest
+//               de kopie van de knoop waarop hij draait. Dat klopt enkel zolang de thread niet naar
+//               een andere socket verhuist: pinCurrentThread zet hem vast.
+//
+// Alles valt terug zonder te falen: explicit zonder pool wordt thp, thp zonder kernelsteun blijft
+// gewone pagina's, één knoop (of geen Linux) geeft één kopie. describe() zegt wat er echt gebeurde
+// (voor THP gemeten in /proc/self/smaps, want madvise is maar een verzoek).
+
+enum class HugePages { Off, Transparent, Explicit };
+
+inline HugePages parseHugePages(const std::string& value) {
+    if (value == "off") return HugePages::Off;
+    if (value == "thp") return HugePages::Transparent;
+    if (value == "explicit") return HugePages::Explicit;
+    throw std::invalid_argument("Ongeldige waarde voor huge pages: " + value + " (off, thp of explicit)");
+}
+
+struct TablePlacement {
+    HugePages huge_pages = HugePages::Off;
+    bool numa_replicate = false;
+
+    bool enabled() const { return huge_pages != HugePages::Off || numa_replicate; }
+};
+
+// --- NUMA-topologie (Linux: /sys/devices/system/node) ---
+
+// "0-3,8-11" -> {0,1,2,3,8,9,10,11}
+inline std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream fields(list);
+    std::string range;
+    while (std::getline(fields, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+// CPU's per knoop, geïndexeerd op knoopnummer (lege vector = knoop bestaat niet). Zonder sysfs: één knoop.
+inline const std::vector<std::vector<int>>& numaTopology() {
+    static const std::vector<std::vector<int>> topology = [] {
+        std::vector<std::vector<int>> nodes;
+#ifdef __linux__
+        for (int node = 0; node < 1024; ++node) {
+            std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!in) {
+                if (node >= 64 && !nodes.empty()) break;   // knoopnummers mogen gaten hebben, maar niet eindeloos
+                continue;
+            }
+            std::string list;
+            std::getline(in, list);
+            nodes.resize(node + 1);
+            nodes[node] = parseCpuList(list);
+        }
+#endif
+        if (nodes.empty()) nodes.push_back({});
+        return nodes;
+    }();
+    return topology;
+}
+
+inline int numaNodeCount() {
+    const auto& nodes = numaTopology();
+    return std::max<int>(1, static_cast<int>(std::count_if(nodes.begin(), nodes.end(), [](const auto& cpus) { return !cpus.empty(); })));
+}
+
+// Knoop van de huidige thread, per thread onthouden (getcpu kost ~20-50 ns, te veel per score).
+// pinCurrentThread werkt hem bij; een niet-vastgepinde thread houdt de knoop van zijn eerste oproep.
+inline int& cachedNumaNode() {
+    thread_local int node = -1;
+    return node;
+}
+
+inline int currentNumaNode() {
+    int& node = cachedNumaNode();
+    if (node < 0) {
+        node = 0;
+#if defined(__linux__) && defined(SYS_getcpu)
+        unsigned cpu = 0, current = 0;
+        if (syscall(SYS_getcpu, &cpu, &current, nullptr) == 0) node = static_cast<int>(current);
+#endif
+    }
+    return node;
+}
+
+// Zet de huidige thread vast op een CPU. Threads 0, 1, 2, ... gaan om beurt naar elke knoop
+// (knoop 0 cpu 0, knoop 1 cpu 0, knoop 0 cpu 1, ...), zodat een half gevulde pool beide sockets
+// gebruikt. Geeft de CPU terug, of -1 als vastpinnen niet kan (geen Linux, of geweigerd).
+inline int pinCurrentThread(unsigned index) {
+#ifdef __linux__
+    std::vector<std::pair<int, int>> order;          // (cpu, knoop)
+    const auto& nodes = numaTopology();
+    for (size_t round = 0;; ++round) {
+        bool any = false;
+        for (size_t node = 0; node < nodes.size(); ++node) {
+            if (round < nodes[node].size()) {
+                order.push_back({nodes[node][round], static_cast<int>(node)});
+                any = true;
+            }
+        }
+        if (!any) break;
+    }
+    if (order.empty()) {
+        long count = sysconf(_SC_NPROCESSORS_ONLN);
+        for (long cpu = 0; cpu < count; ++cpu) order.push_back({static_cast<int>(cpu), 0});
+    }
+    if (order.empty()) return -1;
+    auto [cpu, node] = order[index % order.size()];
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) return -1;
+    cachedNumaNode() = node;
+    return cpu;
+#else
+    (void)index;
+    return -1;
+#endif
+}
+
+// --- Geheugen ---
+
+// Eén blok geheugen, met de gevraagde paginagrootte en eventueel gebonden aan een knoop.
+class PlacedBuffer {
+public:
+    static constexpr size_t HUGE_PAGE = size_t{2} << 20;
+
+    PlacedBuffer(size_t bytes, HugePages huge_pages, int node) {
+#ifdef __linux__
+        if (huge_pages == HugePages::Explicit) {
+            size = roundUp(bytes, HUGE_PAGE);
+            void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p != MAP_FAILED) {
+                memory = p;
+                pages = "hugetlb 2 MiB";
+            } else {
+                note = "geen gereserveerde huge pages (vm.nr_hugepages), terug naar thp";
+                huge_pages = HugePages::Transparent;
+            }
+        }
+        if (!memory) {
+            // Op een 2 MiB-grens leggen: enkel volledig uitgelijnde stukken worden huge pages.
+            size = huge_pages == HugePages::Transparent ? roundUp(bytes, HUGE_PAGE) : roundUp(bytes, 4096);
+            size_t slack = huge_pages == HugePages::Transparent ? HUGE_PAGE : 0;
+            void* p = mmap(nullptr, size + slack, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) throw std::bad_alloc();
+            uintptr_t base = reinterpret_cast<uintptr_t>(p);
+            uintptr_t aligned = slack ? roundUp(base, HUGE_PAGE) : base;
+            if (aligned > base) munmap(p, aligned - base);
+            if (slack && base + slack > aligned) munmap(reinterpret_cast<void*>(aligned + size), base + slack - aligned);
+            memory = reinterpret_cast<void*>(aligned);
+            pages = "4 KiB";
+#ifdef MADV_HUGEPAGE
+            if (huge_pages == HugePages::Transparent && madvise(memory, size, MADV_HUGEPAGE) == 0) pages = "thp";
+#endif
+        }
+        if (node >= 0) bindToNode(node);
+#else
+        (void)huge_pages;
+        (void)node;
+        size = bytes;
+        memory = std::malloc(std::max<size_t>(bytes, 1));
+        if (!memory) throw std::bad_alloc();
+        pages = "standaard";
+#endif
+    }
+
+    ~PlacedBuffer() {
+        if (!memory) return;
+#ifdef __linux__
+        munmap(memory, size);
+#else
+        std::free(memory);
+#endif
+    }
+
+    PlacedBuffer(const PlacedBuffer&) = delete;
+    PlacedBuffer& operator=(const PlacedBuffer&) = delete;
+
+    void* data() const { return memory; }
+
+    // Na het vullen: hoeveel van het blok echt op huge pages staat (THP is maar een verzoek).
+    std::string describe() const {
+        std::ostringstream out;
+        out << pages;
+        if (pages == "thp") {
+            size_t huge = anonHugeBytes();
+            out << " (" << huge / 1024 << " van " << size / 1024 << " KiB op huge pages)";
+        }
+        if (!bound.empty()) out << ", " << bound;
+        if (!note.empty()) out << "; " << note;
+        return out.str();
+    }
+
+private:
+    static size_t roundUp(size_t value, size_t multiple) { return (value + multiple - 1) / multiple * multiple; }
+
+    // mbind(MPOL_BIND) vóór de eerste schrijf: de pagina's komen dan op die knoop.
+    // Rechtstreeks via syscall, zodat libnuma niet nodig is.
+    void bindToNode(int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+        const int MPOL_BIND_MODE = 2;
+        unsigned long mask[16] = {};
+        if (node >= static_cast<int>(sizeof(mask) * 8)) return;
+        mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+        if (syscall(SYS_mbind, memory, size, MPOL_BIND_MODE, mask, sizeof(mask) * 8, 0) == 0) {
+            bound = "knoop " + std::to_string(node);
+        } else {
+            bound = "knoop " + std::to_string(node) + " gevraagd, mbind geweigerd";
+        }
+#else
+        (void)node;
+#endif
+    }
+
+    // AnonHugePages van de mapping waarin het blok ligt (een aangrenzende mapping met dezelfde
+    // rechten kan door de kernel samengevoegd zijn; dan telt die mee).
+    size_t anonHugeBytes() const {
+#ifdef __linux__
+        std::ifstream smaps("/proc/self/smaps");
+        uintptr_t address = reinterpret_cast<uintptr_t>(memory);
+        std::string line;
+        bool inside = false;
+        while (std::getline(smaps, line)) {
+            unsigned long long first = 0, last = 0;
+            char dash = 0;
+            std::istringstream header(line);
+            if (line.find('-') != std::string::npos && std::isxdigit(static_cast<unsigned char>(line[0])) &&
+                (header >> std::hex >> first >> dash >> last) && dash == '-') {
+                inside = address >= first && address < last;
+                continue;
+            }
+            if (inside && line.rfind("AnonHugePages:", 0) == 0) {
+                return std::stoull(line.substr(14)) * 1024;
+            }
+        }
+#endif
+        return 0;
+    }
+
+    void* memory = nullptr;
+    size_t size = 0;
+    std::string pages;
+    std::string bound;
+    std::string note;
+};
+
+// Een alleen-lezen tabel, eventueel op huge pages en met een kopie per NUMA-knoop.
+// Kopiëren deelt de geplaatste kopieën (ze veranderen niet meer).
+template <typename T>
+class PlacedTable {
+public:
+    bool placed() const { return static_cast<bool>(copies); }
+
+    void place(const std::vector<T>& source, const TablePlacement& placement) {
+        auto fresh = std::make_shared<Copies>();
+        const auto& nodes = numaTopology();
+        std::vector<int> targets;
+        if (placement.numa_replicate && numaNodeCount() > 1) {
+            for (size_t node = 0; node < nodes.size(); ++node) {
+                if (!nodes[node].empty()) targets.push_back(static_cast<int>(node));
+            }
+        } else {
+            targets.push_back(-1);
+        }
+        fresh->by_node.assign(nodes.size(), nullptr);
+        for (int node : targets) {
+            auto buffer = std::make_unique<PlacedBuffer>(source.size() * sizeof(T), placement.huge_pages, node);
+            std::memcpy(buffer->data(), source.data(), source.size() * sizeof(T));
+            const T* data = static_cast<const T*>(buffer->data());
+            if (node >= 0) fresh->by_node[node] = data;
+            fresh->buffers.push_back(std::move(buffer));
+        }
+        fresh->first = static_cast<const T*>(fresh->buffers.front()->data());
+        for (auto& p : fresh->by_node) if (!p) p = fresh->first;
+        fresh->replicated = targets.size() > 1;
+        if (placement.numa_replicate && !fresh->replicated) fresh->note = "1 NUMA-knoop, geen kopieën";
+        copies = std::move(fresh);
+    }
+
+    // De kopie voor de huidige thread, of 'fallback' als de tabel niet geplaatst is.
+    const T* local(const T* fallback) const {
+        if (!copies) return fallback;
+        if (!copies->replicated) return copies->first;
+        size_t node = static_cast<size_t>(currentNumaNode());
+        return node < copies->by_node.size() ? copies->by_node[node] : copies->first;
+    }
+
+    std::string describe() const {
+        if (!copies) return "gewone vector (4 KiB-pagina's)";
+        std::ostringstream out;
+        out << copies->buffers.size() << (copies->buffers.size() == 1 ? " kopie" : " kopieën");
+        if (!copies->note.empty()) out << " (" << copies->note << ")";
+        for (size_t i = 0; i < copies->buffers.size(); ++i) out << (i == 0 ? ": " : " | ") << copies->buffers[i]->describe();
+        return out.str();
+    }
+
+private:
+    struct Copies {
+        std::vector<std::unique_ptr<PlacedBuffer>> buffers;
+        std::vector<const T*> by_node;       // per knoopnummer
+        const T* first = nullptr;
+        bool replicated = false;
+        std::string note;
+    };
+    std::shared_ptr<const Copies> copies;
+};
+
+#endif // COMMON_TABLEPLACEMENT_H
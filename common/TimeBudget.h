@@ -0,0 +1,112 @@
+#ifndef COMMON_TIMEBUDGET_H
+#define COMMON_TIMEBUDGET_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+
+#include "Anneal.h"
+
+// Anytime-modus voor de solvers (--time-budget SECONDEN): de run stopt op de klok in plaats van
+// na een vast aantal iteraties, en het koelschema wordt onderweg bijgesteld naar de gemeten
+// snelheid van deze machine.
+//
+// Het schema blijft het afgestelde GeometricSchedule; enkel 'cooling' verandert. De annealer is
+// afgesteld op N iteraties (bv. 3M voor Playfair) en eindigt dan op T_eind = start * cooling^N.
+// Onder een budget wordt de koeling telkens zo gezet dat de temperatuur T_eind bereikt precies
+// wanneer het budget op is, gegeven het aantal it/s tot nu toe. Herstarts (opwarmen) blijven zoals
+// ze zijn; na een herstart koelt het schema gewoon sneller af om op tijd te eindigen.
+//
+// Signalen (met installAnytimeSignals):
+//   SIGUSR1          de huidige beste sleutel en plaintext afdrukken, de run gaat door;
+//   SIGINT, SIGTERM  netjes stoppen met het beste resultaat tot nu toe (een tweede keer: meteen).
+
+inline volatile std::sig_atomic_t anytime_publish_requested = 0;
+inline volatile std::sig_atomic_t anytime_stop_requested = 0;
+
+extern "C" inline void onAnytimeSignal(int signal_number) {
+#ifdef SIGUSR1
+    if (signal_number == SIGUSR1) {
+        anytime_publish_requested = 1;
+        return;
+    }
+#endif
+    anytime_stop_requested = 1;
+    std::signal(signal_number, SIG_DFL);
+}
+
+inline void installAnytimeSignals() {
+    std::signal(SIGINT, onAnytimeSignal);
+    std::signal(SIGTERM, onAnytimeSignal);
+#ifdef SIGUSR1
+    std::signal(SIGUSR1, onAnytimeSignal);
+#endif
+}
+
+// true als er sinds de vorige oproep om een tussenstand gevraagd is.
+inline bool takePublishRequest() {
+    if (!anytime_publish_requested) return false;
+    anytime_publish_requested = 0;
+    return true;
+}
+
+inline bool stopRequested() { return anytime_stop_requested != 0; }
+
+class TimeBudget {
+public:
+    // De klok wordt elke CHECK_EVERY iteraties gelezen (~20 ns, verwaarloosbaar).
+    static constexpr long long CHECK_EVERY = 1024;
+    static constexpr double RATE_WINDOW = 0.25;
+
+    // 'tuned' en 'tuned_iterations': het schema en de run waarop de solver afgesteld is.
+    TimeBudget(double seconds, const GeometricSchedule& tuned, long long tuned_iterations)
+        : seconds(seconds), final_temperature(tuned.start * std::pow(tuned.cooling, static_cast<double>(tuned_iterations))),
+          started(Clock::now()), last_check(started) {}
+
+    double elapsed() const { return std::chrono::duration<double>(Clock::now() - started).count(); }
+    double budget() const { return seconds; }
+    double finalTemperature() const { return final_temperature; }
+    // Gladgestreken snelheid zoals gebruikt voor de koeling.
+    double iterationsPerSecond() const { return rate; }
+
+    // Vanuit onIteration van de observer: false = budget op of stop gevraagd. Stelt 'cooling' van
+    // het schema bij zodat de temperatuur T_eind haalt bij het einde van het budget.
+    bool check(long long iteration, GeometricSchedule& schedule) {
+        if (iteration % CHECK_EVERY != 0) return true;
+        if (stopRequested()) return false;
+        Clock::time_point now = Clock::now();
+        double total = std::chrono::duration<double>(now - started).count();
+        if (total >= seconds) return false;
+
+        // Snelheid over vensters van minstens RATE_WINDOW s, voortschrijdend gemiddeld: ze verandert
+        // tijdens de run (bv. een score-cache die opwarmt, of reeksen cache-hits na een herstart),
+        // maar één uitschieter mag de koeling niet doen springen. Tot de eerste meting blijft het
+        // afgestelde schema gelden.
+        double window = std::chrono::duration<double>(now - last_check).count();
+        if (window >= RATE_WINDOW) {
+            double measured = (iteration - last_iteration) / window;
+            rate = rate == 0.0 ? measured : rate + 0.5 * (measured - rate);
+            last_iteration = iteration;
+            last_check = now;
+        }
+        if (rate == 0.0) return true;
+
+        double remaining = std::max(1.0, rate * (seconds - total));
+        double current = schedule.temperature();
+        schedule.cooling = current > final_temperature ? std::exp(std::log(final_temperature / current) / remaining) : 1.0;
+        return true;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    double seconds;
+    double final_temperature;
+    Clock::time_point started;
+    Clock::time_point last_check;
+    long long last_iteration = 0;
+    double rate = 0.0;
+};
+
+#endif // COMMON_TIMEBUDGET_H
@@ -0,0 +1,245 @@
+// Client voor de solver-daemon: stuurt jobs naar de Unix-socket en drukt de antwoorden af
+// (één JSON-object per regel) tot alle jobs klaar zijn.
+//
+//   ./solver_client --socket /tmp/codetheorie.sock --cipher playfair --in ../playfair/02-OPGAVE-playfair.txt --seconds 60
+//   ./solver_client --socket /tmp/codetheorie.sock --cipher adfgvx --in bericht.txt --set transposition=4,0,6,2,1,3,5
+//   ./solver_client --socket /tmp/codetheorie.sock < jobs.jsonl         # ruwe JSON-lines doorsturen
+//   ./solver_client --socket /tmp/codetheorie.sock --cancel j1
+//   ./solver_client --selftest                  # controleert --set en de JSON-roundtrip (ctest)
+//
+// Exitcode: 0 als alle jobs "solved" of "finished" eindigen, 2 als er één time-out of annulering
+// was, 1 bij fouten of geweigerde aanvragen.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cmath>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "../common/JsonLine.h"
+
+using namespace std;
+
+string read_file(const string& path) {
+    ifstream in(path);
+    if (!in) throw runtime_error("Kon bestand niet openen: " + path);
+    stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+bool send_all(int fd, const string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+        if (n <= 0) return false;
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// --set sleutel=waarde: een waarde die als geheel een getal is, gaat als getal (gehele getallen
+// exact, ook grote seeds); al de rest als string, zoals de bereiken widths=5-7 of key_lens=1-3.
+void set_option(JsonObject& job, const string& key, const string& text) {
+    size_t used = 0;
+    try {
+        long long whole = stoll(text, &used);
+        if (used == text.size()) {
+            job.set(key, whole);
+            return;
+        }
+        used = 0;
+        double number = stod(text, &used);
+        if (used == text.size() && isfinite(number)) {       // "nan"/"inf" zijn geen JSON-getallen
+            job.set(key, number);
+            return;
+        }
+    } catch (const exception&) {
+        // geen getal
+    }
+    job.set(key, text);
+}
+
+// Zelftest zonder daemon: --set-waarden en parse(dump(x)) == x voor de velden die het protocol gebruikt.
+int selftest() {
+    int failures = 0;
+    auto check = [&](bool ok, const string& what) {
+        if (!ok) {
+            cerr << "MISLUKT: " << what << endl;
+            failures++;
+        }
+    };
+
+    JsonObject job;
+    set_option(job, "widths", "5-7");
+    set_option(job, "key_lens", "1-3");
+    set_option(job, "iterations", "10000000");
+    set_option(job, "seed", "12345678901234567");
+    set_option(job, "temperature", "0.25");
+    set_option(job, "transposition", "4,0,6,2,1,3,5");
+    set_option(job, "model", "english");
+    set_option(job, "note", "nan");
+    job.set("ciphertext", "A\"B\\C\nD\te\x01");
+    job.set("final", true);
+    string line = job.dump();
+
+    JsonObject back = JsonObject::parse(line);
+    check(back.getString("widths") == "5-7", "widths=5-7 blijft een string: " + line);
+    check(back.getString("key_lens") == "1-3", "key_lens=1-3 blijft een string: " + line);
+    check(back.getInt("iterations") == 10000000, "iterations als geheel getal: " + line);
+    check(back.getUnsigned("seed") == 12345678901234567ULL, "seed exact: " + line);
+    check(back.getNumber("temperature") == 0.25, "temperature als getal: " + line);
+    check(back.getString("transposition") == "4,0,6,2,1,3,5", "transposition als string: " + line);
+    check(back.getString("model") == "english", "model: " + line);
+    check(back.getString("note") == "nan", "nan blijft een string: " + line);
+    check(back.getString("ciphertext") == "A\"B\\C\nD\te\x01", "escapes in strings: " + line);
+    check(back.getBool("final"), "bool: " + line);
+    check(back.dump() == line, "parse(dump(x)).dump() == dump(x): " + back.dump());
+
+    for (const char* bad : {"{\"a\":}", "{\"a\":[1]}", "{\"a\":1} x", "{\"a\" 1}"}) {
+        bool rejected = false;
+        try {
+            JsonObject::parse(bad);
+        } catch (const invalid_argument&) {
+            rejected = true;
+        }
+        check(rejected, string("ongeldige JSON geweigerd: ") + bad);
+    }
+
+    cout << (failures ? "Zelftest mislukt." : "Zelftest geslaagd.") << endl;
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 2 && string(argv[1]) == "--selftest") return selftest();
+
+    string socket_path = "/tmp/codetheorie.sock";
+    JsonObject job;
+    string input_path;
+    string cancel_id;
+    bool final_only = false;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("Ontbrekende waarde voor " + arg);
+            return argv[++i];
+        };
+        try {
+            if (arg == "--socket") socket_path = value();
+            else if (arg == "--cipher") job.set("cipher", value());
+            else if (arg == "--in") input_path = value();
+            else if (arg == "--id") job.set("id", value());
+            else if (arg == "--model") job.set("model", value());
+            else if (arg == "--seconds") job.set("seconds", stod(value()));
+            else if (arg == "--seed") job.set("seed", stoull(value()));
+            else if (arg == "--set") {
+                // Eender welke joboptie als sleutel=waarde (getallen blijven getallen).
+                string kv = value();
+                size_t eq = kv.find('=');
+                if (eq == string::npos) throw runtime_error("verwacht sleutel=waarde");
+                set_option(job, kv.substr(0, eq), kv.substr(eq + 1));
+            }
+            else if (arg == "--cancel") cancel_id = value();
+            else if (arg == "--final") final_only = true;
+            else {
+                cerr << "Onbekende optie: " << arg << endl;
+                cerr << "Gebruik: solver_client [--socket pad] (--cipher naam --in bestand [--id ID] [--model naam]"
+                        " [--seconds S] [--seed N] [--set sleutel=waarde]... | --cancel ID | < jobs.jsonl) [--final] | --selftest" << endl;
+                return 1;
+            }
+        } catch (const exception& ex) {
+            cerr << "Ongeldige waarde voor " << arg << ": " << ex.what() << endl;
+            return 1;
+        }
+    }
+
+    // De aanvragen: één job uit de opties, een annulering, of ruwe regels van stdin.
+    vector<string> requests;
+    try {
+        if (!cancel_id.empty()) {
+            requests.push_back(JsonObject().set("cancel", cancel_id).dump());
+        } else if (job.has("cipher")) {
+            if (input_path.empty()) throw runtime_error("--in ontbreekt");
+            job.set("ciphertext", read_file(input_path));
+            requests.push_back(job.dump());
+        } else {
+            for (string line; getline(cin, line);) {
+                if (line.find_first_not_of(" \t\r") != string::npos) requests.push_back(line);
+            }
+        }
+    } catch (const exception& ex) {
+        cerr << ex.what() << endl;
+        return 1;
+    }
+    if (requests.empty()) return 0;
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        cerr << "Kon niet verbinden met " << socket_path << ": " << strerror(errno) << endl;
+        return 1;
+    }
+    string payload;
+    for (const string& r : requests) payload += r + "\n";
+    if (!send_all(fd, payload)) {
+        cerr << "Kon de aanvragen niet versturen." << endl;
+        return 1;
+    }
+
+    // Elke aanvraag krijgt één antwoord; elke aanvaarde job eindigt met één "done".
+    // De verbinding blijft open tot dan: sluiten annuleert de jobs.
+    size_t answered = 0;
+    size_t running = 0;
+    int exit_code = 0;
+    string buffer;
+    char chunk[4096];
+    while (answered < requests.size() || running > 0) {
+        size_t newline = buffer.find('\n');
+        if (newline == string::npos) {
+            ssize_t n = ::read(fd, chunk, sizeof(chunk));
+            if (n <= 0) {
+                cerr << "De daemon sloot de verbinding." << endl;
+                return 1;
+            }
+            buffer.append(chunk, static_cast<size_t>(n));
+            continue;
+        }
+        string line = buffer.substr(0, newline);
+        buffer.erase(0, newline + 1);
+
+        string event;
+        string status;
+        try {
+            JsonObject response = JsonObject::parse(line);
+            event = response.getString("event");
+            status = response.getString("status");
+        } catch (const exception&) {
+            // Geen geldig antwoord: gewoon doorgeven.
+        }
+        if (event == "queued") {
+            answered++;
+            running++;
+        } else if (event == "cancelling") {
+            answered++;
+        } else if (event == "rejected") {
+            answered++;
+            exit_code = 1;
+        } else if (event == "done") {
+            if (running > 0) running--;
+            if (status == "error") exit_code = 1;
+            else if ((status == "timeout" || status == "cancelled") && exit_code == 0) exit_code = 2;
+        }
+        bool terminal = event == "done" || event == "rejected" || event == "cancelling";
+        if (!final_only || terminal) cout << line << endl;
+    }
+    ::close(fd);
+    return exit_code;
+}
@@ -0,0 +1,695 @@
+// Solver-daemon: laadt de taalmodellen één keer en verwerkt een stroom jobs (JSON lines) voor
+// Playfair, ADFGVX en Vigenère-plus op een gedeelde pool van worker-threads.
+//
+//   cd daemon && ../build/solver_daemon --socket /tmp/codetheorie.sock --models english,spanish
+//   cd daemon && ../build/solver_daemon < jobs.jsonl > results.jsonl      # via stdin/stdout
+//
+// Protocol (één JSON-object per regel, zie README.md):
+//   {"id":"j1","cipher":"playfair","ciphertext":"...","seconds":30,"model":"english"}
+//   {"cancel":"j1"}
+// Elke aanvraag krijgt één antwoord ("queued", "cancelling" of "rejected"); een job meldt daarna
+// "started", tussentijdse "best"-records en tot slot precies één "done".
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "../common/JsonLine.h"
+#include "../common/QuadgramScorer.h"
+#include "../common/Permutation.h"
+#include "../playfair/PlayfairAnneal.h"
+#include "../adfgvx/SquareAnneal.h"
+#include "../adfgvx/Crib.h"
+#include "../viginereplus/AnnealSearch.h"
+
+using namespace std;
+
+// --- Verbindingen ---
+
+// Waar de events van een job heen gaan: stdout of een client-socket. Schrijven is thread-safe;
+// na een schrijffout of het sluiten door de client is de verbinding dicht en worden haar jobs
+// geannuleerd.
+class Connection {
+public:
+    Connection(int read_fd, int write_fd, bool owns_fd) : read_fd(read_fd), write_fd(write_fd), owns_fd(owns_fd) {}
+    ~Connection() {
+        if (owns_fd) ::close(write_fd);
+    }
+
+    void send(const JsonObject& event) {
+        string line = event.dump() + "\n";
+        lock_guard<mutex> lock(write_mutex);
+        if (!open) return;
+        size_t written = 0;
+        while (written < line.size()) {
+            ssize_t n = ::write(write_fd, line.data() + written, line.size() - written);
+            if (n <= 0) {
+                open = false;
+                return;
+            }
+            written += static_cast<size_t>(n);
+        }
+    }
+
+    bool isOpen() const { return open; }
+    void close() { open = false; }
+    int readFd() const { return read_fd; }
+
+private:
+    int read_fd;
+    int write_fd;
+    bool owns_fd;
+    mutex write_mutex;
+    atomic<bool> open{true};
+};
+
+// Leest regels van een file descriptor (stdin of socket) tot EOF.
+bool read_line(int fd, string& buffer, string& line) {
+    while (true) {
+        size_t newline = buffer.find('\n');
+        if (newline != string::npos) {
+            line = buffer.substr(0, newline);
+            buffer.erase(0, newline + 1);
+            return true;
+        }
+        char chunk[4096];
+        ssize_t n = ::read(fd, chunk, sizeof(chunk));
+        if (n <= 0) {
+            if (buffer.empty()) return false;
+            line.swap(buffer);
+            buffer.clear();
+            return true;
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+    }
+}
+
+// --- Taalmodellen ---
+
+// Elk model wordt bij het eerste gebruik (of via --models bij het opstarten) één keer geladen
+// en daarna door alle jobs gedeeld (alleen gelezen).
+// Met een TablePlacement komt de quadgramtabel van elk model op huge pages en/of in een kopie per
+// NUMA-knoop (common/TablePlacement.h), vóór een job hem gebruikt.
+class ModelCache {
+public:
+    ModelCache(filesystem::path data_dir, TablePlacement placement) : data_dir(move(data_dir)), placement(placement) {}
+
+    const QuadgramScorer& scorer(const string& name) {
+        lock_guard<mutex> lock(m);
+        return scorerLocked(name);
+    }
+
+    // Voor Vigenère-plus: "dutch" is het ingebouwde Nederlandse model (zie JointAnneal.h).
+    const PlaintextModel& plaintextModel(const string& name) {
+        lock_guard<mutex> lock(m);
+        auto& model = plaintext_models[name];
+        if (!model) {
+            model = make_unique<PlaintextModel>(name == "dutch" ? PlaintextModel::dutch() : PlaintextModel(scorerLocked(name)));
+        }
+        return *model;
+    }
+
+private:
+    const QuadgramScorer& scorerLocked(const string& name) {
+        if (name.empty() || name.find_first_of("/\\.") != string::npos) throw invalid_argument("Ongeldige modelnaam: " + name);
+        auto& scorer = scorers[name];
+        if (!scorer) {
+            auto started = chrono::steady_clock::now();
+            try {
+                scorer = make_unique<QuadgramScorer>((data_dir / (name + "_quadgrams.txt")).string());
+                scorer->placeTable(placement);
+            } catch (...) {
+                scorers.erase(name);
+                throw;
+            }
+            cerr << "Model " << name << " geladen in "
+                 << chrono::duration<double>(chrono::steady_clock::now() - started).count() << " s";
+            if (placement.enabled()) cerr << "; tabel: " << scorer->describeTablePlacement();
+            cerr << endl;
+        }
+        return *scorer;
+    }
+
+    filesystem::path data_dir;
+    TablePlacement placement;
+    mutex m;
+    map<string, unique_ptr<QuadgramScorer>> scorers;
+    map<string, unique_ptr<PlaintextModel>> plaintext_models;
+};
+
+// --- Jobs ---
+
+struct Job {
+    string id;
+    JsonObject request;
+    shared_ptr<Connection> out;
+    double seconds_budget = 60;
+    uint64_t seed = 0;                     // uit de aanvraag of willekeurig; staat in "done"
+
+    atomic<bool> cancelled{false};
+    mutex interrupt_mutex;
+    atomic<bool>* interrupt = nullptr;     // extra stopvlag van een lopende zoektocht (Vigenère-plus)
+
+    void cancel() {
+        cancelled = true;
+        lock_guard<mutex> lock(interrupt_mutex);
+        if (interrupt) *interrupt = true;
+    }
+
+    void setInterrupt(atomic<bool>* flag) {
+        lock_guard<mutex> lock(interrupt_mutex);
+        interrupt = flag;
+        if (flag && cancelled) *flag = true;
+    }
+};
+
+struct Outcome {
+    string status = "finished";            // solved, finished, timeout, cancelled
+    double score = 0;
+    JsonObject fields;                     // key, plaintext, ...
+    uint64_t iterations = 0;
+};
+
+// Wat een solver tijdens een job nodig heeft: stoppen (annuleren, tijdsbudget, client weg)
+// en nieuwe records melden, hooguit een paar keer per seconde.
+class JobContext {
+public:
+    explicit JobContext(Job& job) : job(job), started(chrono::steady_clock::now()) {}
+
+    double elapsed() const { return chrono::duration<double>(chrono::steady_clock::now() - started).count(); }
+    bool timedOut() const { return elapsed() > job.seconds_budget; }
+    bool cancelled() const { return job.cancelled || !job.out->isOpen(); }
+    bool shouldStop() const { return cancelled() || timedOut(); }
+
+    // describe() levert de velden van het record (sleutel, plaintext) en wordt enkel opgeroepen
+    // als het record ook echt verstuurd wordt.
+    void improved(double score, const function<JsonObject()>& describe) {
+        auto now = chrono::steady_clock::now();
+        if (now - last_report < chrono::milliseconds(250)) return;
+        last_report = now;
+        JsonObject event;
+        event.set("id", job.id).set("event", "best").set("score", score).set("elapsed", elapsed());
+        event.merge(describe());
+        job.out->send(event);
+    }
+
+    string status(bool solved) const {
+        if (solved) return "solved";
+        if (cancelled()) return "cancelled";
+        if (timedOut()) return "timeout";
+        return "finished";
+    }
+
+    Job& job;
+
+private:
+    chrono::steady_clock::time_point started;
+    chrono::steady_clock::time_point last_report{};
+};
+
+// Koppelt een Annealer-run aan een job: stopt bij annuleren of tijdsbudget (elke 256 iteraties
+// gecontroleerd) en bij het halen van de doelscore, en meldt nieuwe records.
+template <typename Describe>
+struct JobObserver : AnnealObserver {
+    JobContext& ctx;
+    Describe describe;
+    bool has_target;
+    double target;
+    bool reached_target = false;
+
+    JobObserver(JobContext& ctx, Describe describe, bool has_target, double target)
+        : ctx(ctx), describe(move(describe)), has_target(has_target), target(target) {}
+
+    bool onBest(long long, const string& key, double score, double) {
+        ctx.improved(score, [&] { return describe(key); });
+        if (has_target && score >= target) {
+            reached_target = true;
+            return false;
+        }
+        return true;
+    }
+    bool onIteration(long long i, double, double, double) { return (i & 255) != 0 || !ctx.shouldStop(); }
+};
+
+// Enkel stoppen (fase 1 van ADFGVX: de records per transpositie zijn geen nieuws).
+struct StopObserver : AnnealObserver {
+    JobContext& ctx;
+    explicit StopObserver(JobContext& ctx) : ctx(ctx) {}
+    bool onIteration(long long i, double, double, double) { return (i & 255) != 0 || !ctx.shouldStop(); }
+};
+
+string letters_only(const string& text) {
+    string out;
+    for (char c : text) {
+        if (isalpha(static_cast<unsigned char>(c))) out += static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    }
+    return out;
+}
+
+vector<int> parse_order(string text) {
+    replace(text.begin(), text.end(), ',', ' ');
+    istringstream fields(text);
+    vector<int> order;
+    for (int k; fields >> k;) order.push_back(k);
+    return order;
+}
+
+string join_order(const vector<int>& order) {
+    string out;
+    for (size_t i = 0; i < order.size(); ++i) out += (i ? "," : "") + to_string(order[i]);
+    return out;
+}
+
+// Opties: model (spanish), iterations (3000000), seed, target_score.
+Outcome run_playfair(JobContext& ctx, ModelCache& models) {
+    const JsonObject& r = ctx.job.request;
+    string ciphertext = letters_only(r.getString("ciphertext"));
+    replace(ciphertext.begin(), ciphertext.end(), 'J', 'I');
+    if (ciphertext.size() % 2 != 0) ciphertext.pop_back();
+    if (ciphertext.size() < 4) throw invalid_argument("Ciphertext te kort.");
+    const QuadgramScorer& scorer = models.scorer(r.getString("model", "spanish"));
+
+    Rng rng(ctx.job.seed);
+    string key = "ABCDEFGHIKLMNOPQRSTUVWXYZ";
+    rng.shuffle(key);
+
+    auto describe = [&](const string& k) {
+        Playfair cipher;
+        cipher.setKey(k);
+        JsonObject fields;
+        fields.set("key", k).set("plaintext", cipher.decrypt(ciphertext));
+        return fields;
+    };
+    PlayfairAnnealer annealer = makePlayfairAnnealer(scorer, ciphertext);
+    JobObserver<decltype(describe)> observer(ctx, describe, r.has("target_score"), r.getNumber("target_score"));
+    auto result = annealer.run(key, rng, r.getInt("iterations", 3000000), observer);
+
+    Outcome outcome;
+    outcome.status = ctx.status(observer.reached_target);
+    outcome.score = result.best_score;
+    outcome.fields = describe(result.best);
+    outcome.fields.set("cache_hit_rate", annealer.cacheStats().hitRate());
+    outcome.iterations = result.iterations;
+    return outcome;
+}
+
+// Opties: model (spaceless_english), transposition "k,k,..." (slaat fase 1 over), width (7),
+// phase1_iterations (20000 per transpositie), phase1_warm_iterations (een vierde daarvan), iterations (10000000, fase 2), seed, target_score.
+// De ciphertext mag in morse (zoals de opgave) of als ADFGVX-letters.
+Outcome run_adfgvx(JobContext& ctx, ModelCache& models) {
+    const JsonObject& r = ctx.job.request;
+    string raw = r.getString("ciphertext");
+    string ciphertext = raw.find_first_of(".-") != string::npos ? morseToADFGVX(raw) : letters_only(raw);
+    if (ciphertext.size() % 2 != 0) ciphertext.pop_back();
+    if (ciphertext.empty() || ciphertext.find_first_not_of("ADFGVX") != string::npos) {
+        throw invalid_argument("Ciphertext moet uit morse of de letters ADFGVX bestaan.");
+    }
+    const QuadgramScorer& scorer = models.scorer(r.getString("model", "spaceless_english"));
+    Outcome outcome;
+
+    // Fase 1: alle transposities van de gegeven breedte, elk met een korte annealing-run; zoals
+    // find_transposition in SJT-volgorde, warm gestart vanuit de vorige permutatie van het blok.
+    vector<int> order = parse_order(r.getString("transposition"));
+    if (order.empty()) {
+        int width = static_cast<int>(r.getInt("width", 7));
+        if (width < 2 || width > 10) throw invalid_argument("width moet tussen 2 en 10 liggen (of geef transposition mee).");
+        long phase1_iterations = r.getInt("phase1_iterations", 20000);
+        long warm_iterations = r.getInt("phase1_warm_iterations", phase1_iterations / 4);
+        SquareAnnealer<false> phase1 = makeTranspositionAnnealer(scorer, freeCells(CribPins()));
+        double best_phase1 = -1e18;
+        string warm_square;
+        for (uint64_t index = 0; index < factorial(width) && !ctx.shouldStop(); ++index) {
+            if (index % TRANSPOSITION_BLOCK == 0) warm_square.clear();
+            vector<int> perm = permutationFromSjtIndex(width, index);
+            Rng rng(ctx.job.seed, index);                // zoals find_transposition
+            phase1.scorer().setTransposition(ciphertext, perm);
+            if (!phase1.scorer().valid()) continue;
+            bool warm = warm_iterations > 0 && !warm_square.empty();
+            phase1.schedule() = warm ? warmTranspositionSchedule() : transpositionSchedule();
+            string square = warm ? warm_square : randomPinnedSquare(CribPins(), rng);
+            auto result = phase1.run(square, rng, warm ? warm_iterations : phase1_iterations, StopObserver(ctx));
+            warm_square = result.best;
+            outcome.iterations += result.iterations;
+            if (result.best_score > best_phase1) {
+                best_phase1 = result.best_score;
+                order = perm;
+                ctx.improved(result.best_score, [&] {
+                    JsonObject fields;
+                    fields.set("phase", 1).set("transposition", join_order(perm));
+                    return fields;
+                });
+            }
+        }
+        if (order.empty()) throw invalid_argument("Geen enkele transpositie geeft geldige digrafen.");
+    }
+
+    // Fase 2: het Polybius-vierkant voor de (beste) transpositie.
+    ADFGVX cipher;
+    cipher.setKeys("ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789", order);   // valideert de volgorde
+    SquareAnnealer<true> phase2 = makeSquareAnnealer(scorer, freeCells(CribPins()));
+    phase2.scorer().setTransposition(ciphertext, order);
+    if (!phase2.scorer().valid()) throw invalid_argument("De ciphertext geeft geen geldige digrafen onder deze transpositie.");
+    auto describe = [&](const string& square) {
+        cipher.setKeys(square, order);
+        JsonObject fields;
+        fields.set("phase", 2).set("key", square).set("transposition", join_order(order)).set("plaintext", cipher.decrypt(ciphertext));
+        return fields;
+    };
+    Rng rng(ctx.job.seed);                               // zoals solve_square
+    string square = randomPinnedSquare(CribPins(), rng);
+    JobObserver<decltype(describe)> observer(ctx, describe, r.has("target_score"), r.getNumber("target_score"));
+    auto result = ctx.shouldStop() ? AnnealResult<string>{square, -1e9, 0}
+                                   : phase2.run(square, rng, r.getInt("iterations", 10000000), observer);
+
+    outcome.status = ctx.status(observer.reached_target);
+    outcome.score = result.best_score;
+    outcome.fields = describe(result.best);
+    outcome.iterations += result.iterations;
+    return outcome;
+}
+
+struct Range {
+    int first;
+    int last;
+};
+
+Range parse_range(const string& text) {
+    size_t dash = text.find('-');
+    if (dash == string::npos) return {stoi(text), stoi(text)};
+    return {stoi(text.substr(0, dash)), stoi(text.substr(dash + 1))};
+}
+
+// Opties: model (dutch), widths ("2-25"), key_lens ("1-10"), iterations (per run, standaard
+// afhankelijk van de breedte), temperature ("20-0.5"), seed. Eén thread per job.
+Outcome run_vigenereplus(JobContext& ctx, ModelCache& models) {
+    const JsonObject& r = ctx.job.request;
+    string ciphertext = letters_only(r.getString("ciphertext"));
+    string model_name = r.getString("model", "dutch");
+    Range widths = parse_range(r.getString("widths", "2-25"));
+    Range key_lengths = parse_range(r.getString("key_lens", "1-10"));
+    if (widths.first < 2 || widths.last > 40 || widths.first > widths.last ||
+        key_lengths.first < 1 || key_lengths.first > key_lengths.last) {
+        throw invalid_argument("Ongeldig bereik voor widths of key_lens.");
+    }
+    if (ciphertext.size() < static_cast<size_t>(widths.last)) throw invalid_argument("Ciphertext te kort.");
+    string temperature = r.getString("temperature", "20-0.5");
+    size_t dash = temperature.find('-');
+
+    SolveJob search;
+    search.cipher = &ciphertext;
+    search.model = &models.plaintextModel(model_name);
+    search.dutch = model_name == "dutch";
+    search.start_temperature = stod(temperature.substr(0, dash));
+    search.end_temperature = dash == string::npos ? 0.5 : stod(temperature.substr(dash + 1));
+    search.seconds_budget = ctx.job.seconds_budget;
+    for (int w = widths.first; w <= widths.last; ++w) {
+        for (int l = key_lengths.first; l <= key_lengths.last; ++l) {
+            search.chains.push_back({w, l, chain_iterations(w, r.getInt("iterations", 0))});
+        }
+    }
+    auto describe = [](const SolveJob& s) {
+        JsonObject fields;
+        fields.set("key", s.best.vigenereKey()).set("transposition", join_order(s.best.perm)).set("plaintext", s.best_plain);
+        return fields;
+    };
+    search.on_improved = [&](const SolveJob& s) { ctx.improved(s.best.score, [&] { return describe(s); }); };
+
+    ctx.job.setInterrupt(&search.stop);
+    solve(search, 1, ctx.job.seed);
+    ctx.job.setInterrupt(nullptr);
+
+    Outcome outcome;
+    outcome.status = ctx.status(search.solved);
+    outcome.score = search.best.score;
+    outcome.fields = describe(search);
+    outcome.iterations = search.evaluations;
+    return outcome;
+}
+
+// --- Wachtrij en workers ---
+
+class Daemon {
+public:
+    // pin_threads: worker t vast op een CPU, om beurt over de NUMA-knopen (pinCurrentThread).
+    Daemon(ModelCache& models, int threads, bool pin_threads) : models(models) {
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([this, t, pin_threads] {
+                if (pin_threads && pinCurrentThread(static_cast<unsigned>(t)) < 0) {
+                    cerr << "Worker " << t << ": vastpinnen lukt niet, de thread blijft vrij" << endl;
+                }
+                work();
+            });
+        }
+    }
+
+    // Verwerkt één aanvraagregel van een client.
+    void handle(const string& line, const shared_ptr<Connection>& out) {
+        if (line.find_first_not_of(" \t\r") == string::npos) return;
+        JsonObject request;
+        try {
+            request = JsonObject::parse(line);
+        } catch (const exception& ex) {
+            out->send(JsonObject().set("event", "rejected").set("message", ex.what()));
+            return;
+        }
+
+        if (request.has("cancel")) {
+            string id = request.getString("cancel");
+            shared_ptr<Job> job;
+            {
+                lock_guard<mutex> lock(m);
+                auto it = active.find(id);
+                if (it != active.end()) job = it->second;
+            }
+            if (!job) {
+                out->send(JsonObject().set("id", id).set("event", "rejected").set("message", "Onbekende of afgewerkte job."));
+                return;
+            }
+            job->cancel();
+            out->send(JsonObject().set("id", id).set("event", "cancelling"));
+            return;
+        }
+
+        auto job = make_shared<Job>();
+        job->request = request;
+        job->out = out;
+        try {
+            string cipher = request.getString("cipher");
+            if (cipher != "playfair" && cipher != "adfgvx" && cipher != "vigenereplus") {
+                throw invalid_argument("Onbekend cijfer '" + cipher + "' (playfair, adfgvx of vigenereplus).");
+            }
+            if (!request.has("ciphertext")) throw invalid_argument("Ontbrekend veld 'ciphertext'.");
+            job->seconds_budget = request.getNumber("seconds", 60.0);
+            if (!(job->seconds_budget > 0)) throw invalid_argument("'seconds' moet positief zijn.");
+            job->seed = request.has("seed") ? request.getUnsigned("seed") : randomSeed();
+        } catch (const exception& ex) {
+            out->send(JsonObject().set("id", request.getString("id")).set("event", "rejected").set("message", ex.what()));
+            return;
+        }
+
+        {
+            lock_guard<mutex> lock(m);
+            job->id = request.getString("id", "job-" + to_string(++job_counter));
+            if (active.count(job->id)) {
+                out->send(JsonObject().set("id", job->id).set("event", "rejected").set("message", "Er loopt al een job met deze id."));
+                return;
+            }
+            active[job->id] = job;
+            queue.push_back(job);
+            out->send(JsonObject().set("id", job->id).set("event", "queued").set("position", queue.size()));
+        }
+        cv.notify_one();
+    }
+
+    // Annuleert alle jobs van een verbinding die gesloten werd.
+    void disconnect(const shared_ptr<Connection>& out) {
+        out->close();
+        lock_guard<mutex> lock(m);
+        for (auto& [id, job] : active) {
+            if (job->out == out) job->cancel();
+        }
+    }
+
+    // Geen nieuwe jobs meer; wacht tot de wachtrij leeg is en alle workers klaar zijn.
+    void drain() {
+        {
+            lock_guard<mutex> lock(m);
+            closing = true;
+        }
+        cv.notify_all();
+        for (auto& t : workers) t.join();
+        workers.clear();
+    }
+
+private:
+    void work() {
+        while (true) {
+            shared_ptr<Job> job;
+            {
+                unique_lock<mutex> lock(m);
+                cv.wait(lock, [this] { return closing || !queue.empty(); });
+                if (queue.empty()) return;
+                job = queue.front();
+                queue.pop_front();
+            }
+            run(*job);
+            lock_guard<mutex> lock(m);
+            active.erase(job->id);
+        }
+    }
+
+    void run(Job& job) {
+        JobContext ctx(job);
+        JsonObject done;
+        done.set("id", job.id).set("event", "done");
+        if (ctx.cancelled()) {
+            job.out->send(done.set("status", "cancelled").set("seconds", 0.0));
+            return;
+        }
+        job.out->send(JsonObject().set("id", job.id).set("event", "started"));
+        try {
+            string cipher = job.request.getString("cipher");
+            Outcome outcome = cipher == "playfair" ? run_playfair(ctx, models)
+                            : cipher == "adfgvx"   ? run_adfgvx(ctx, models)
+                                                   : run_vigenereplus(ctx, models);
+            double seconds = ctx.elapsed();
+            done.set("status", outcome.status).set("score", outcome.score).merge(outcome.fields);
+            done.set("seed", job.seed).set("iterations", outcome.iterations).set("seconds", seconds)
+                .set("iterations_per_second", outcome.iterations / max(seconds, 1e-9));
+            job.out->send(done);
+        } catch (const exception& ex) {
+            job.out->send(done.set("status", "error").set("message", ex.what()).set("seconds", ctx.elapsed()));
+        }
+    }
+
+    ModelCache& models;
+    vector<thread> workers;
+    mutex m;
+    condition_variable cv;
+    deque<shared_ptr<Job>> queue;
+    map<string, shared_ptr<Job>> active;     // in de wachtrij of bezig
+    uint64_t job_counter = 0;
+    bool closing = false;
+};
+
+// Bij SIGINT/SIGTERM het socketbestand opruimen.
+char socket_path_for_signal[sizeof(sockaddr_un::sun_path)] = {};
+
+void on_terminate(int) {
+    if (socket_path_for_signal[0]) ::unlink(socket_path_for_signal);
+    _exit(0);
+}
+
+int main(int argc, char* argv[]) {
+    // Start vanuit de map daemon/ zodat basePath klopt.
+    filesystem::path basePath = "../";
+    filesystem::path data_dir = basePath / "data";
+    string socket_path;
+    int threads = max(1u, thread::hardware_concurrency());
+    vector<string> preload;
+    TablePlacement placement;
+    bool pin_threads = false;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("Ontbrekende waarde voor " + arg);
+            return argv[++i];
+        };
+        try {
+            if (arg == "--socket") socket_path = value();
+            else if (arg == "--threads") threads = max(1, stoi(value()));
+            else if (arg == "--data") data_dir = value();
+            else if (arg == "--huge-pages") placement.huge_pages = parseHugePages(value());
+            else if (arg == "--numa-replicate") placement.numa_replicate = true;
+            else if (arg == "--pin-threads") pin_threads = true;
+            else if (arg == "--models") {
+                stringstream list(value());
+                for (string item; getline(list, item, ',');) preload.push_back(item);
+            }
+            else {
+                cerr << "Onbekende optie: " << arg << endl;
+                cerr << "Gebruik: solver_daemon [--socket pad] [--threads N] [--data map] [--models naam,naam] "
+                        "[--huge-pages off|thp|explicit] [--numa-replicate] [--pin-threads]" << endl;
+                return 1;
+            }
+        } catch (const exception& ex) {
+            cerr << "Ongeldige waarde voor " << arg << ": " << ex.what() << endl;
+            return 1;
+        }
+    }
+
+    ModelCache models(data_dir, placement);
+    try {
+        for (const string& name : preload) models.scorer(name);
+    } catch (const exception& ex) {
+        cerr << ex.what() << endl;
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+    Daemon daemon(models, threads, pin_threads);
+
+    if (socket_path.empty()) {
+        // stdin/stdout: na EOF op stdin worden de resterende jobs nog afgewerkt.
+        cerr << "Solver-daemon: " << threads << " workers, jobs via stdin" << endl;
+        auto out = make_shared<Connection>(STDIN_FILENO, STDOUT_FILENO, false);
+        string buffer, line;
+        while (read_line(STDIN_FILENO, buffer, line)) daemon.handle(line, out);
+        daemon.drain();
+        return 0;
+    }
+
+    if (socket_path.size() >= sizeof(sockaddr_un::sun_path)) {
+        cerr << "Socketpad te lang: " << socket_path << endl;
+        return 1;
+    }
+    int listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    ::unlink(socket_path.c_str());   // achtergebleven socket van een vorige run
+    if (listen_fd < 0 || ::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listen_fd, 16) != 0) {
+        cerr << "Kon niet luisteren op " << socket_path << ": " << strerror(errno) << endl;
+        return 1;
+    }
+    strncpy(socket_path_for_signal, socket_path.c_str(), sizeof(socket_path_for_signal) - 1);
+    signal(SIGINT, on_terminate);
+    signal(SIGTERM, on_terminate);
+    cerr << "Solver-daemon: " << threads << " workers, luistert op " << socket_path << endl;
+
+    // Eén leesthread per client; als de client de verbinding sluit, worden zijn jobs geannuleerd.
+    while (true) {
+        int client = ::accept(listen_fd, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR) continue;
+            cerr << "accept: " << strerror(errno) << endl;
+            break;
+        }
+        auto out = make_shared<Connection>(client, client, true);
+        thread([&daemon, out] {
+            string buffer, line;
+            while (out->isOpen() && read_line(out->readFd(), buffer, line)) daemon.handle(line, out);
+            daemon.disconnect(out);
+        }).detach();
+    }
+    ::unlink(socket_path.c_str());
+    return 1;
+}
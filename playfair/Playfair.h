@@ -7,6 +7,8 @@
 #include <stdexcept>
 #include <map>
 #include <utility> // for std::pair
+#include <cctype>
+#include <cstdint>
 
 class Playfair {
 public:
@@ -52,6 +54,79 @@ public:
         return plaintext;
     }
 
+    // Snelle variant van decrypt voor de annealing-lus: sleutel als 25 hoofdletters, ciphertext
+    // en uitvoer als letterindices 0..25 (n even). Bouwt geen matrix of map op.
+    static void decryptLetters(const std::string& key, const uint8_t* ciphertext, size_t n, uint8_t* plaintext) {
+        uint8_t row[26] = {}, col[26] = {};
+        uint8_t letter[25];
+        for (int i = 0; i < 25; ++i) {
+            int x = key[i] - 'A';
+            row[x] = static_cast<uint8_t>(i / 5);
+            col[x] = static_cast<uint8_t>(i % 5);
+            letter[i] = static_cast<uint8_t>(x);
+        }
+        for (size_t i = 0; i + 1 < n; i += 2) {
+            int r1 = row[ciphertext[i]], c1 = col[ciphertext[i]];
+            int r2 = row[ciphertext[i + 1]], c2 = col[ciphertext[i + 1]];
+            if (r1 == r2) { // Zelfde rij
+                c1 = c1 == 0 ? 4 : c1 - 1;
+                c2 = c2 == 0 ? 4 : c2 - 1;
+            } else if (c1 == c2) { // Zelfde kolom
+                r1 = r1 == 0 ? 4 : r1 - 1;
+                r2 = r2 == 0 ? 4 : r2 - 1;
+            } else { // Rechthoek
+                std::swap(c1, c2);
+            }
+            plaintext[i] = letter[r1 * 5 + c1];
+            plaintext[i + 1] = letter[r2 * 5 + c2];
+        }
+    }
+
+    // Versleutelt voorbereide tekst (zie preparePlaintext): het omgekeerde van decrypt.
+    std::string encrypt(const std::string& plaintext) const {
+        std::string ciphertext = "";
+        for (size_t i = 0; i + 1 < plaintext.length(); i += 2) {
+            auto pos1 = coords.at(plaintext[i]);
+            auto pos2 = coords.at(plaintext[i + 1]);
+
+            int r1 = pos1.first, c1_coord = pos1.second;
+            int r2 = pos2.first, c2_coord = pos2.second;
+
+            if (r1 == r2) { // Zelfde rij
+                ciphertext += grid[r1][(c1_coord + 1) % 5];
+                ciphertext += grid[r2][(c2_coord + 1) % 5];
+            } else if (c1_coord == c2_coord) { // Zelfde kolom
+                ciphertext += grid[(r1 + 1) % 5][c1_coord];
+                ciphertext += grid[(r2 + 1) % 5][c2_coord];
+            } else { // Rechthoek
+                ciphertext += grid[r1][c2_coord];
+                ciphertext += grid[r2][c1_coord];
+            }
+        }
+        return ciphertext;
+    }
+
+    // Maakt gewone tekst klaar voor encrypt: enkel letters in hoofdletters, J wordt I, een X
+    // tussen twee gelijke letters van hetzelfde digraf, en een X achteraan bij oneven lengte.
+    static std::string preparePlaintext(const std::string& text) {
+        std::string letters;
+        for (char c : text) {
+            if (std::isalpha(static_cast<unsigned char>(c))) {
+                char u = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+                letters += (u == 'J') ? 'I' : u;
+            }
+        }
+        std::string prepared;
+        for (size_t i = 0; i < letters.length(); ++i) {
+            prepared += letters[i];
+            if (prepared.length() % 2 == 1 && i + 1 < letters.length() && letters[i + 1] == letters[i]) {
+                prepared += (letters[i] == 'X') ? 'Q' : 'X';
+            }
+        }
+        if (prepared.length() % 2 != 0) prepared += (prepared.back() == 'X') ? 'Q' : 'X';
+        return prepared;
+    }
+
 private:
     std::string key_string;
     char grid[5][5]{};
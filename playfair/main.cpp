@@ -8,9 +8,15 @@
 #include <random>
 #include <filesystem> // C++17 voor paden
 #include <cmath>      // voor exp()
+#include <chrono>
+#include <memory>
+#include <limits>
 
 #include "QuadgramScorer.h"
 #include "Playfair.h"
+#include "PlayfairAnneal.h"
+#include "../common/TimeBudget.h"
+#include "../common/ResultRecord.h"
 
 // Functie om de ciphertext uit het bestand te lezen en voor te bereiden (ongewijzigd)
 std::string loadAndPrepareCiphertext(const std::string& filepath) {
@@ -39,16 +45,65 @@ std::string loadAndPrepareCiphertext(const std::string& filepath) {
     return cleaned_text;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
         // --- CONFIGURATIE ---
         // Start dit programma vanuit de map playfair/ zodat basePath klopt.
         std::filesystem::path basePath = "../";
         std::string ciphertext_path = (basePath / "playfair" / "02-OPGAVE-playfair.txt").string();
-        std::string quadgrams_path = (basePath / "data" / "spanish_quadgrams.txt").string();
+        std::string model_name = "spanish";
         std::string output_filepath = (basePath / "playfair" / "decrypted_solution.txt").string();
 
-        const int MAX_ITERATIONS = 3000000;
+        int MAX_ITERATIONS = 3000000;
+        uint64_t seed = randomSeed();
+        // Optioneel (o.a. voor bench/solve_bench): stoppen zodra de beste score dit haalt.
+        bool has_target = false;
+        double target_score = 0.0;
+        // Met CODETHEORIE_PROFILE: fase-profiel van de annealing-lus (common/AnnealProfile.h).
+        std::string profile_path = "anneal_profile.json";
+        int cache_bits = 16;                  // --cache BITS: score-cache van 2^BITS sleutels (0 = uit)
+        // Anytime: --time-budget S loopt S seconden en rekt het schema van --iterations daarover uit
+        // (common/TimeBudget.h); SIGUSR1 toont de huidige beste, Ctrl-C stopt met het beste resultaat.
+        double time_budget = 0.0;
+        // --results PREFIX: ook een gestructureerde record (top-K, statistieken) naar PREFIX.jsonl en
+        // PREFIX.bin (common/ResultRecord.h); --results-top K kandidaten (standaard 10).
+        std::string results_prefix;
+        size_t results_top = 10;
+
+        for (int a = 1; a < argc; ++a) {
+            std::string arg = argv[a];
+            if (arg == "--in" && a + 1 < argc) {
+                ciphertext_path = argv[++a];
+            } else if (arg == "--out" && a + 1 < argc) {
+                output_filepath = argv[++a];
+            } else if (arg == "--model" && a + 1 < argc) {
+                model_name = argv[++a];
+            } else if (arg == "--seed" && a + 1 < argc) {
+                seed = std::stoull(argv[++a]);
+            } else if (arg == "--iterations" && a + 1 < argc) {
+                MAX_ITERATIONS = std::stoi(argv[++a]);
+            } else if (arg == "--cache" && a + 1 < argc) {
+                cache_bits = std::stoi(argv[++a]);
+            } else if (arg == "--time-budget" && a + 1 < argc) {
+                time_budget = std::stod(argv[++a]);
+            } else if (arg == "--results" && a + 1 < argc) {
+                results_prefix = argv[++a];
+            } else if (arg == "--results-top" && a + 1 < argc) {
+                results_top = std::stoul(argv[++a]);
+            } else if (arg == "--profile" && a + 1 < argc) {
+                profile_path = argv[++a];
+                if (!ANNEAL_PROFILE) std::cerr << "Let op: --profile werkt enkel als gecompileerd met CODETHEORIE_PROFILE." << std::endl;
+            } else if (arg == "--target-score" && a + 1 < argc) {
+                target_score = std::stod(argv[++a]);
+                has_target = true;
+            } else {
+                throw std::invalid_argument("Onbekend argument: " + arg +
+                    " (gebruik: [--in bestand] [--out bestand] [--model naam] [--seed N] [--iterations N] [--time-budget S] [--cache BITS] [--target-score S] [--results prefix [--results-top K]] [--profile bestand])");
+            }
+        }
+        std::string quadgrams_path = (basePath / "data" / (model_name + "_quadgrams.txt")).string();
+        std::unique_ptr<ResultWriter> results;
+        if (!results_prefix.empty()) results = std::make_unique<ResultWriter>(results_prefix);
 
         // --- INITIALISATIE ---
         std::cout << "Laden van quadgrams van: " << quadgrams_path << std::endl;
@@ -59,88 +114,119 @@ int main() {
         std::cout << "Ciphertext geladen (" << ciphertext.length() << " tekens)." << std::endl;
 
         Playfair cipher;
-        std::mt19937 rng(std::random_device{}());
+        Rng rng(seed);
+        std::cout << "Seed " << seed << " (--seed " << seed << " herhaalt deze run)." << std::endl;
 
 //        used in begin. we are starting from a better key now. no need to shuffle
         std::string parent_key = "ABCDEFGHIKLMNOPQRSTUVWXYZ";
-        std::shuffle(parent_key.begin(), parent_key.end(), rng);
+        rng.shuffle(parent_key);
         //std::string parent_key = "YTVWXIGABRQELCMHUZDFSKNOP";
-        std::string best_key = parent_key;
-
-        cipher.setKey(parent_key);
-        double parent_score = scorer.score(cipher.decrypt(ciphertext));
-
-        double best_score = parent_score;
-
-        // --- SIMULATED ANNEALING LOOP ---
-        std::cout << "\nStarten van de simulated annealing aanval..." << std::endl;
 
-        double temperature = 50.0;
-        double cooling_rate = 0.999995;
-        int stagnation_limit = 20000;
-        int stagnation_counter = 0;
-
-        std::uniform_int_distribution<int> dist(0, 24);
-        std::uniform_real_distribution<double> real_dist(0.0, 1.0);
-
-        for (int i = 0; i < MAX_ITERATIONS; ++i) {
-            std::string child_key = parent_key;
-            int choice = rng() % 2;  // choose between two mutation types
+        // --- SIMULATED ANNEALING (common/Anneal.h, instellingen in PlayfairAnneal.h) ---
+        PlayfairAnnealer annealer = makePlayfairAnnealer(scorer, ciphertext);
+        annealer.enableScoreCache(cache_bits);
+
+        std::unique_ptr<TimeBudget> budget;
+        long long iteration_limit = MAX_ITERATIONS;
+        if (time_budget > 0.0) {
+            budget = std::make_unique<TimeBudget>(time_budget, annealer.schedule(), MAX_ITERATIONS);
+            iteration_limit = std::numeric_limits<long long>::max();
+            installAnytimeSignals();
+            std::cout << "Tijdsbudget " << time_budget << " s: het schema van " << MAX_ITERATIONS
+                      << " iteraties wordt over het budget uitgerekt (eindtemperatuur " << budget->finalTemperature() << ")." << std::endl;
+        }
 
-            if (choice == 0) {
-                // Type 1: swap two random letters
-                int a = dist(rng), b = dist(rng);
-                std::swap(child_key[a], child_key[b]);
-            } else {
-                // Type 2: reverse a random section (helps larger changes)
-                int start = dist(rng), end = dist(rng);
-                if (start > end) std::swap(start, end);
-                std::reverse(child_key.begin() + start, child_key.begin() + end);
+        struct Progress : AnnealObserver {
+            const std::string& ciphertext;
+            bool has_target;
+            double target_score;
+            TimeBudget* budget;                       // nullptr = vaste iteraties
+            GeometricSchedule& schedule;
+            std::string best_key;
+            double best_score = 0.0;
+            ResultCandidates& candidates;
+
+            Progress(const std::string& ciphertext, bool has_target, double target_score, TimeBudget* budget,
+                     GeometricSchedule& schedule, ResultCandidates& candidates)
+                : ciphertext(ciphertext), has_target(has_target), target_score(target_score), budget(budget),
+                  schedule(schedule), candidates(candidates) {}
+
+            bool onBest(long long i, const std::string& key, double score, double temperature) {
+                best_key = key;
+                best_score = score;
+                candidates.add(score, key);
+                Playfair shown;
+                shown.setKey(key);
+                std::cout << "Iteratie " << i << " | Beste Score: " << score << " | Temp: " << temperature << std::endl;
+                std::cout << "Tekst: " << shown.decrypt(ciphertext).substr(0, 100) << "..." << std::endl;
+                std::cout << "Sleutel: " << key << "\n" << std::endl;
+                return !(has_target && score >= target_score);
             }
-
-            cipher.setKey(child_key);
-            double child_score = scorer.score(cipher.decrypt(ciphertext));
-            double delta = child_score - parent_score;
-
-            if (delta > 0 || exp(delta / temperature) > real_dist(rng)) {
-                parent_key = child_key;
-                parent_score = child_score;
+            bool onIteration(long long i, double, double, double temperature) {
+                if (!budget) return true;
+                if (takePublishRequest() && !best_key.empty()) {
+                    Playfair shown;
+                    shown.setKey(best_key);
+                    std::cout << "--- Tussenstand na " << budget->elapsed() << " s, iteratie " << i << " (Temp: " << temperature
+                              << ", " << budget->iterationsPerSecond() << " it/s) ---" << std::endl;
+                    std::cout << "Beste score: " << best_score << "\nSleutel: " << best_key << std::endl;
+                    std::cout << "Tekst: " << shown.decrypt(ciphertext) << "\n" << std::endl;
+                }
+                return budget->check(i, schedule);
             }
-
-            if (parent_score > best_score) {
-                best_score = parent_score;
-                best_key = parent_key;
-                stagnation_counter = 0;
-
-                std::cout << "Iteratie " << i << " | Beste Score: " << best_score << " | Temp: " << temperature << std::endl;
-                std::cout << "Tekst: " << cipher.decrypt(ciphertext).substr(0, 100) << "..." << std::endl;
-                std::cout << "Sleutel: " << best_key << "\n" << std::endl;
-            } else {
-                stagnation_counter++;
+            void onRestart(long long i) {
+                std::cout << "\n--- Stagnatie bereikt. Herstart bij iteratie " << i << " ---\n" << std::endl;
             }
+        };
 
-            temperature *= cooling_rate;
-
-            if (stagnation_counter >= stagnation_limit) {
-                std::cout << "\n--- Stagnatie bereikt. Herstart bij iteratie " << i << " ---\n" << std::endl;
+        std::cout << "\nStarten van de simulated annealing aanval..." << std::endl;
+        auto started = std::chrono::steady_clock::now();
+        ResultCandidates candidates(results_top);
+        auto result = annealer.run(parent_key, rng, iteration_limit,
+                                   Progress(ciphertext, has_target, target_score, budget.get(), annealer.schedule(), candidates));
+        long long iterations_done = result.iterations;
+        std::string best_key = result.best;
+        double best_score = result.best_score;
 
-//        used in begin. we are starting from a better key now. no need to shuffle
-//                std::shuffle(parent_key.begin(), parent_key.end(), rng);
-
-            parent_key = best_key;
-            int a = dist(rng), b = dist(rng);
-            std::swap(parent_key[a], parent_key[b]);
-            cipher.setKey(parent_key);
-            parent_score = scorer.score(cipher.decrypt(ciphertext));
-            stagnation_counter = 0;
-            temperature = 20.0;
-            }
-        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
 
         // --- RESULTAAT ---
         std::cout << "\n--- Aanval voltooid ---" << std::endl;
+        std::cout << "Iteraties: " << iterations_done << " in " << seconds << " s ("
+                  << iterations_done / std::max(seconds, 1e-9) << " it/s)" << std::endl;
+        if (budget && (stopRequested() || budget->elapsed() >= time_budget)) {
+            std::cout << (stopRequested() ? "Gestopt op verzoek" : "Tijdsbudget op") << " na " << seconds << " van "
+                      << time_budget << " s (eindtemperatuur " << annealer.schedule().temperature() << ")." << std::endl;
+        }
         std::cout << "Beste gevonden sleutel: " << best_key << std::endl;
         std::cout << "Beste score: " << best_score << std::endl;
+        if (cache_bits > 0) std::cout << describeScoreCache(annealer.cacheStats(), annealer.cacheBytes()) << std::endl;
+        if constexpr (ANNEAL_PROFILE) {
+            writeAnnealProfile(annealer.profile(), "playfair", profile_path);
+            std::cout << "Profiel geschreven naar: " << profile_path << std::endl;
+        }
+
+        if (results) {
+            ResultRecord record;
+            record.solver = "playfair_cracker";
+            record.status = has_target && best_score >= target_score ? "solved"
+                          : stopRequested() ? "cancelled"
+                          : budget && budget->elapsed() >= time_budget ? "timeout" : "finished";
+            record.model = model_name;
+            record.input = ciphertext_path;
+            record.seed = seed;
+            record.iterations = iterations_done;
+            record.seconds = seconds;
+            if (cache_bits > 0) record.addInfo("cache_hit_rate", annealer.cacheStats().hitRate());
+            record.top = candidates.ranked();
+            if (record.top.empty()) record.top.push_back({best_score, best_key, ""});
+            for (ResultCandidate& candidate : record.top) {
+                cipher.setKey(candidate.key);
+                candidate.plaintext = cipher.decrypt(ciphertext);
+            }
+            results->submit(std::move(record));
+            std::cout << "Resultaatrecord naar: " << results->jsonPath() << " en " << results->binaryPath() << std::endl;
+        }
 
         cipher.setKey(best_key);
         std::string decrypted_text = cipher.decrypt(ciphertext);
@@ -154,7 +240,7 @@ int main() {
         if (output_file.is_open()) {
             output_file << "Beste gevonden sleutel: " << best_key << std::endl;
             output_file << "Beste score: " << best_score << std::endl;
-            output_file << "Aantal iteraties: " << MAX_ITERATIONS << std::endl;
+            output_file << "Aantal iteraties: " << iterations_done << std::endl;
             output_file << "------------------------------------\n\n";
             output_file << decrypted_text << std::endl;
             output_file.close();
@@ -0,0 +1,143 @@
+#ifndef VIGINEREPLUS_ANNEALSEARCH_H
+#define VIGINEREPLUS_ANNEALSEARCH_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+
+#include "Vigenere.h"
+#include "JointAnneal.h"
+#include "../common/ResultRecord.h"
+
+// De zoektocht rond JointAnnealer: ketens per (breedte, sleutellengte), verdeeld over threads.
+// Gedeeld door anneal_solver en de solver-daemon.
+
+// Eén (breedte, sleutellengte)-combinatie waarop een keten annealt.
+struct Chain {
+    int width;
+    int key_length;
+    long iterations;
+};
+
+// Onder breedte 10 volstaan een paar duizend iteraties per run; daarboven groeit het
+// benodigde aantal ongeveer kwadratisch (gemeten met --selftest). override > 0 wint.
+inline long chain_iterations(int width, long override_iterations = 0) {
+    if (override_iterations > 0) return override_iterations;
+    return width < 10 ? 3000L : 200L * width * width;
+}
+
+// Gedeeld tussen de threads van één zoektocht.
+struct SolveJob {
+    const std::string* cipher;
+    const PlaintextModel* model;
+    bool dutch = false;
+    const std::string* expected = nullptr;      // zelftest: de echte plaintext
+    std::vector<Chain> chains;
+    double start_temperature = 0;
+    double end_temperature = 0;
+
+    std::vector<uint64_t> spent;                // geplande iteraties per keten
+    std::atomic<bool> stop{false};              // ook van buitenaf te zetten (annuleren)
+    std::atomic<uint64_t> evaluations{0};
+    std::chrono::steady_clock::time_point started;
+    double seconds_budget = 0;
+
+    // Optioneel: opgeroepen (onder m) telkens best/best_plain verandert.
+    std::function<void(const SolveJob&)> on_improved;
+
+    std::mutex m;
+    JointKey best;
+    std::string best_plain;
+    int best_hits = 0;                          // hoeveel runs de beste plaintext vonden
+    bool solved = false;
+    double solved_after = 0;
+    size_t runs_done = 0;
+    ResultCandidates candidates{0};             // top-K over de runs (enkel voor --results; 0 = uit)
+    uint64_t runs_started = 0;                  // volgnummer van de volgende run (eigen Rng-stroom)
+};
+
+inline double elapsed(const SolveJob& job) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - job.started).count();
+}
+
+// Sleutel in een resultaatrecord: de kolomvolgorde, dan de Vigenère-sleutel, bv. "3 1 0 2 | KEY".
+inline std::string jointKeyText(const JointKey& key) {
+    return keyText(key.perm) + " | " + key.vigenereKey();
+}
+
+// Een plaintext telt als opgelost als (zelftest) hij gelijk is aan het origineel, (Nederlands)
+// de woordentaalcheck haalt, of (quadgrammodel) een tweede onafhankelijke run hem terugvindt.
+inline bool accept_solution(SolveJob& job, const std::string& plain) {
+    if (job.expected) return plain == *job.expected;
+    if (job.dutch) return dutch_word_density(plain) >= LANGUAGE_CONFIDENCE_THRESHOLD;
+    return job.best_hits >= 2;
+}
+
+// Run n (in de volgorde waarin runs gestart worden) krijgt de keten en de Rng-stroom (seed, n),
+// welke thread hem ook uitvoert. Met dezelfde seed en zonder tijdslimiet levert run n dus altijd
+// dezelfde sleutel, onafhankelijk van het aantal threads.
+inline void anneal_worker(uint64_t seed, SolveJob* job) {
+    std::map<int, std::unique_ptr<JointAnnealer>> annealers;   // per breedte
+
+    while (!job->stop.load(std::memory_order_relaxed)) {
+        if (elapsed(*job) > job->seconds_budget) break;
+        // De keten die na nog een run het minst iteraties gebruikt heeft: zo krijgt elke
+        // (breedte, sleutellengte) evenveel rekentijd, en lopen kleine breedtes al tientallen
+        // keren voor een grote breedte zijn eerste run krijgt.
+        size_t pick = 0;
+        uint64_t run_index;
+        {
+            std::lock_guard<std::mutex> lock(job->m);
+            for (size_t c = 1; c < job->chains.size(); ++c) {
+                if (job->spent[c] + job->chains[c].iterations < job->spent[pick] + job->chains[pick].iterations) pick = c;
+            }
+            job->spent[pick] += job->chains[pick].iterations;
+            run_index = job->runs_started++;
+        }
+        const Chain& chain = job->chains[pick];
+        Rng rng(seed, run_index);
+
+        auto& annealer = annealers[chain.width];
+        if (!annealer) annealer = std::make_unique<JointAnnealer>(*job->cipher, chain.width, *job->model);
+        uint64_t before = annealer->evaluations();
+        JointKey result = annealer->run(chain.key_length, rng, chain.iterations,
+                                        job->start_temperature, job->end_temperature, job->stop);
+        job->evaluations += annealer->evaluations() - before;
+        std::string plain = annealer->plaintext(result);
+
+        std::lock_guard<std::mutex> lock(job->m);
+        job->runs_done++;
+        if (job->candidates.capacity() > 0) job->candidates.add(result.score, jointKeyText(result), plain);
+        if (plain == job->best_plain) {
+            job->best_hits++;
+        } else if (result.score > job->best.score) {
+            job->best = result;
+            job->best_plain = plain;
+            job->best_hits = 1;
+            if (job->on_improved) job->on_improved(*job);
+        }
+        if (!job->solved && job->best_plain == plain && accept_solution(*job, plain)) {
+            job->solved = true;
+            job->solved_after = elapsed(*job);
+            job->stop = true;
+        }
+    }
+}
+
+inline void solve(SolveJob& job, int threads, uint64_t seed) {
+    job.spent.assign(job.chains.size(), 0);
+    job.runs_started = 0;
+    job.started = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) pool.emplace_back(anneal_worker, seed, &job);
+    for (auto& t : pool) t.join();
+}
+
+#endif // VIGINEREPLUS_ANNEALSEARCH_H
@@ -0,0 +1,131 @@
+#ifndef VIGINEREPLUS_COLUMNARIC_H
+#define VIGINEREPLUS_COLUMNARIC_H
+
+#include <string>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+// Berekent score_vigenere_potential(decrypt_columnar(cipher, key)) zonder de getransponeerde
+// tekst op te bouwen: per permutatie worden enkel de startposities van de kolommen in de
+// ciphertext bepaald, en de letterhistogrammen van alle periodieke slices (sleutellengte 2..10,
+// elke offset) worden rechtstreeks uit de ciphertext geteld. Geen allocaties per permutatie.
+//
+// De IC-waarden zijn bit-identiek aan score_vigenere_potential: de som van
+// c*(c-1) is een exacte gehele waarde, en deling en middeling gebeuren in dezelfde volgorde.
+class ColumnarICScorer {
+public:
+    static const int MAX_KEY_LEN = 10;
+    static const int MAX_WIDTH = 64;
+    static const int NUM_PERIODS = MAX_KEY_LEN - 1;  // sleutellengtes 2..10
+
+    ColumnarICScorer(const std::string& cipher, int width) : width(width) {
+        if (width < 1 || width > MAX_WIDTH) {
+            throw std::invalid_argument("Transpositiebreedte moet tussen 1 en 64 liggen.");
+        }
+        len = static_cast<int>(cipher.length());
+        height = (len + width - 1) / width;
+        num_full_cols = len % width;
+        if (num_full_cols == 0) num_full_cols = width;
+
+        letters.resize(cipher.length());
+        for (size_t i = 0; i < cipher.length(); ++i) {
+            int letter = cipher[i] - 'A';
+            if (letter < 0 || letter >= 26) {
+                throw std::invalid_argument("Ciphertext mag enkel hoofdletters A-Z bevatten.");
+            }
+            letters[i] = static_cast<uint8_t>(letter);
+        }
+
+        // Lengte van elke slice (positie j in de plaintext zit in slice j % L).
+        for (int key_len = 1; key_len <= MAX_KEY_LEN; ++key_len) {
+            for (int i = 0; i < key_len; ++i) {
+                int n = (len > i) ? (len - i + key_len - 1) / key_len : 0;
+                slice_len[key_len][i] = n;
+            }
+        }
+
+        // Indexkaart: voor elke kolom c, rij r en sleutellengte L de plaats van slice ((r * width + c) % L)
+        // in de tellerbuffer. Zo is het tellen per teken enkel nog tabelopzoekingen.
+        slice_offsets.resize(static_cast<size_t>(width) * height * NUM_PERIODS);
+        for (int c = 0; c < width; ++c) {
+            for (int r = 0; r < height; ++r) {
+                uint16_t* o = slice_offsets.data() + (static_cast<size_t>(c) * height + r) * NUM_PERIODS;
+                for (int key_len = 2; key_len <= MAX_KEY_LEN; ++key_len) {
+                    int s = (r * width + c) % key_len;
+                    o[key_len - 2] = static_cast<uint16_t>(&counts[key_len][s][0] - &counts[0][0][0]);
+                }
+            }
+        }
+
+        // Sleutellengte 1 is de volledige tekst: onafhankelijk van de permutatie.
+        std::array<uint32_t, 26> total{};
+        for (uint8_t l : letters) total[l]++;
+        whole_text_ic = icFromCounts(total.data(), len);
+    }
+
+    // Gemiddelde IC van de beste sleutellengte (1..10) voor deze kolomvolgorde.
+    double score(const std::vector<int>& key) {
+        // Startpositie van elke fysieke kolom in de ciphertext (zelfde logica als decrypt_columnar).
+        int current_pos = 0;
+        for (int k : key) {
+            col_start[k] = current_pos;
+            current_pos += (k < num_full_cols) ? height : height - 1;
+        }
+
+        std::memset(counts, 0, sizeof(counts));
+        uint32_t* flat = &counts[0][0][0];
+        for (int c = 0; c < width; ++c) {
+            const uint8_t* chunk = letters.data() + col_start[c];
+            int col_len = (c < num_full_cols) ? height : height - 1;
+            const uint16_t* offsets = slice_offsets.data() + static_cast<size_t>(c) * height * NUM_PERIODS;
+            // Per teken 9 onafhankelijke tellers (één per sleutellengte 2..10): veel parallellisme.
+            for (int r = 0; r < col_len; ++r) {
+                uint32_t x = chunk[r];
+                const uint16_t* o = offsets + static_cast<size_t>(r) * NUM_PERIODS;
+                for (int k = 0; k < NUM_PERIODS; ++k) flat[o[k] + x]++;
+            }
+        }
+
+        double max_avg_ic = 0.0;
+        for (int key_len = 1; key_len <= MAX_KEY_LEN; ++key_len) {
+            double total_ic;
+            if (key_len == 1) {
+                total_ic = 0.0 + whole_text_ic;
+            } else {
+                total_ic = 0.0;
+                for (int i = 0; i < key_len; ++i) {
+                    total_ic += icFromCounts(counts[key_len][i], slice_len[key_len][i]);
+                }
+            }
+            double avg_ic = total_ic / key_len;
+            if (avg_ic > max_avg_ic) max_avg_ic = avg_ic;
+        }
+        return max_avg_ic;
+    }
+
+private:
+    int width;
+    int len;
+    int height;
+    int num_full_cols;
+    std::vector<uint8_t> letters;
+    std::vector<uint16_t> slice_offsets;
+    int slice_len[MAX_KEY_LEN + 1][MAX_KEY_LEN]{};
+    double whole_text_ic = 0.0;
+
+    // Scratch-buffers, hergebruikt voor elke permutatie.
+    int col_start[MAX_WIDTH]{};
+    uint32_t counts[MAX_KEY_LEN + 1][MAX_KEY_LEN][26]{};
+
+    static double icFromCounts(const uint32_t* c, size_t n) {
+        if (n <= 1) return 0.0;
+        uint64_t sum = 0;
+        for (int k = 0; k < 26; ++k) sum += static_cast<uint64_t>(c[k]) * (c[k] - 1);
+        return static_cast<double>(sum) / (n * (n - 1));
+    }
+};
+
+#endif // VIGINEREPLUS_COLUMNARIC_H
@@ -0,0 +1,311 @@
+#ifndef VIGINEREPLUS_JOINTANNEAL_H
+#define VIGINEREPLUS_JOINTANNEAL_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <numeric>
+#include <climits>
+
+#include "../common/QuadgramScorer.h"
+#include "../common/Random.h"
+#include "Vigenere.h"
+
+// Gezamenlijke simulated annealing over kolomvolgorde en Vigenère-sleutel, voor breedtes
+// (12..25) waar het aflopen van alle permutaties in vigenereplus_solver niet meer kan.
+
+// Fitness op letterindices 0..25: een vlakke 26^4-tabel per quadgram (zoals
+// QuadgramScorer::scoreLetters), plus log-letterfrequenties om per slice een shift te passen.
+class PlaintextModel {
+public:
+    // Quadgrammodel uit data/ (english, french, spanish, spaceless_english).
+    explicit PlaintextModel(const QuadgramScorer& scorer) : table(scorer.letterTable()) {
+        const double* freq = scorer.letterFrequencies();
+        for (int x = 0; x < 26; ++x) log_freq[x] = std::log10(std::max(freq[x], 1e-5));
+        rotate();
+    }
+
+    // Nederlands: er is geen Nederlands n-grammodel in data/. Elke tabelentry geeft dan de
+    // unigramscore van de nieuwste letter, plus een bonus als er op die plaats een woord uit
+    // DUTCH_WORDS begint. Zonder die bonus wint een rij-anagram (zelfde letters, hogere IC).
+    static PlaintextModel dutch() {
+        PlaintextModel model;
+        for (int x = 0; x < 26; ++x) model.log_freq[x] = std::log10(std::max(DUTCH_FREQ[x] / 100.0, 1e-5));
+        model.table.resize(QuadgramScorer::TABLE_SIZE);
+        for (size_t index = 0; index < QuadgramScorer::TABLE_SIZE; ++index) {
+            model.table[index] = static_cast<float>(model.log_freq[index % 26]);
+        }
+        const double WORD_BONUS = 1.5;
+        for (const char* word : DUTCH_WORDS) {
+            std::string w(word);
+            size_t prefix = std::min<size_t>(w.size(), 4);
+            size_t base = 0;
+            for (size_t i = 0; i < prefix; ++i) base = base * 26 + (w[i] - 'A');
+            size_t free_letters = 4 - prefix;   // woorden van 3 letters: elke vierde letter
+            size_t span = 1;
+            for (size_t i = 0; i < free_letters; ++i) span *= 26;
+            for (size_t tail = 0; tail < span; ++tail) model.table[base * span + tail] += WORD_BONUS;
+        }
+        model.rotate();
+        return model;
+    }
+
+    double score(const uint8_t* letters, size_t n) const {
+        if (n < 4) return 0.0;
+        const float* t = table.data();
+        double total = 0.0;
+        for (size_t i = 0; i + 3 < n; ++i) {
+            size_t index = ((letters[i] * 26 + letters[i + 1]) * 26 + letters[i + 2]) * 26 + letters[i + 3];
+            total += t[index];
+        }
+        return total;
+    }
+
+    double logFrequency(int letter) const { return log_freq[letter]; }
+
+    // shifted(s)[x] ~ 1024 * logFrequency(x - s): de log-likelihood van cipherletter x onder
+    // shift s, in vaste komma zodat de som per slice vectoriseert.
+    const int32_t* shifted(int s) const { return rotated[s]; }
+
+private:
+    PlaintextModel() = default;
+
+    void rotate() {
+        for (int s = 0; s < 26; ++s) {
+            for (int x = 0; x < 26; ++x) rotated[s][x] = static_cast<int32_t>(std::lround(1024 * log_freq[(x - s + 26) % 26]));
+        }
+    }
+
+    std::vector<float> table;
+    double log_freq[26]{};
+    int32_t rotated[26][32]{};   // opgevuld tot 32 letters
+};
+
+// Een volledige sleutel: permutatie in de conventie van decrypt_columnar plus de Vigenère-shifts.
+struct JointKey {
+    std::vector<int> perm;
+    std::vector<int> shifts;
+    double score = -1e300;
+
+    std::string vigenereKey() const {
+        std::string key;
+        for (int s : shifts) key += static_cast<char>('A' + s);
+        return key;
+    }
+};
+
+// Eén instantie per thread: bevat de buffers en telt de evaluaties. De ciphertext en het
+// model worden gedeeld (alleen gelezen).
+class JointAnnealer {
+public:
+    JointAnnealer(const std::string& cipher, int width, const PlaintextModel& model)
+        : model(model), width(width), length(cipher.size()) {
+        for (char c : cipher) letters.push_back(static_cast<uint8_t>(c - 'A'));
+        height = (length + width - 1) / width;
+        full_columns = length % width == 0 ? width : length % width;
+        arranged.resize(length);
+        candidate.resize(length);
+        plain.resize(length);
+        starts.resize(width);
+        perm.resize(width);
+    }
+
+    // Eén annealingrun voor een vaste sleutellengte, gevolgd door hill climbing.
+    // Temperaturen zijn in log10-eenheden per 1000 letters.
+    JointKey run(int key_length, Rng& rng, long iterations,
+                 double start_temperature, double end_temperature, const std::atomic<bool>& stop) {
+        std::vector<int> columns(width);   // kolom in het grid -> chunk van de ciphertext
+        std::iota(columns.begin(), columns.end(), 0);
+        rng.shuffle(columns);
+        std::vector<int> shifts(key_length);
+
+        arrange(columns, arranged);
+        fitShifts(arranged, shifts);
+        double current = score(arranged, shifts);
+
+        JointKey best;
+        remember(best, columns, shifts, current);
+
+        const double scale = length / 1000.0;
+        double temperature = start_temperature * scale;
+        const double cooling = std::pow(end_temperature / start_temperature, 1.0 / std::max<long>(1, iterations));
+
+        std::vector<int> next_columns;
+        std::vector<int> next_shifts;
+        for (long it = 0; it < iterations; ++it, temperature *= cooling) {
+            if ((it & 1023) == 0 && stop.load(std::memory_order_relaxed)) break;
+
+            next_columns = columns;
+            next_shifts = shifts;
+            int move = rng.below(100);
+            bool columns_moved = move < 70;
+            if (move < 35) {
+                int a = rng.below(width), b = rng.below(width);
+                if (a == b) continue;
+                std::swap(next_columns[a], next_columns[b]);
+            } else if (move < 60) {
+                blockMove(next_columns, rng);
+            } else if (move < 70) {
+                int a = rng.below(width), b = rng.below(width);
+                if (a > b) std::swap(a, b);
+                if (a == b) continue;
+                std::reverse(next_columns.begin() + a, next_columns.begin() + b + 1);
+            } else {
+                next_shifts[rng.below(key_length)] = rng.below(26);
+            }
+
+            double next;
+            if (columns_moved) {
+                arrange(next_columns, candidate);
+                // Na een kolomzet hoort de oude sleutel meestal niet meer bij de slices: pas de
+                // shifts half van de tijd opnieuw aan op de letterfrequenties.
+                if (rng() >> 63) fitShifts(candidate, next_shifts);
+                next = score(candidate, next_shifts);
+            } else {
+                next = score(arranged, next_shifts);
+            }
+
+            if (next >= current || rng.unit() < std::exp((next - current) / temperature)) {
+                current = next;
+                columns.swap(next_columns);
+                shifts.swap(next_shifts);
+                if (columns_moved) arranged.swap(candidate);
+                if (current > best.score) remember(best, columns, shifts, current);
+            }
+        }
+
+        polish(best);
+        return best;
+    }
+
+    std::string plaintext(const JointKey& key) const {
+        return apply_vigenere(decrypt_columnar(cipherText(), key.perm), key.vigenereKey(), -1);
+    }
+
+    uint64_t evaluations() const { return evaluation_count; }
+
+private:
+    std::string cipherText() const {
+        std::string text;
+        for (uint8_t x : letters) text += static_cast<char>('A' + x);
+        return text;
+    }
+
+    // Ciphertextletters in plaintextvolgorde zetten (kolomtranspositie ongedaan maken).
+    void arrange(const std::vector<int>& columns, std::vector<uint8_t>& out) {
+        for (int c = 0; c < width; ++c) perm[columns[c]] = c;
+        int pos = 0;
+        for (int chunk = 0; chunk < width; ++chunk) {
+            starts[chunk] = pos;
+            pos += perm[chunk] < full_columns ? height : height - 1;
+        }
+        for (int c = 0; c < width; ++c) {
+            const uint8_t* src = letters.data() + starts[columns[c]];
+            int rows = c < full_columns ? height : height - 1;
+            for (int r = 0; r < rows; ++r) out[r * width + c] = src[r];
+        }
+    }
+
+    // Per slice de shift met de hoogste log-likelihood onder de letterfrequenties van het model.
+    void fitShifts(const std::vector<uint8_t>& text, std::vector<int>& shifts) {
+        int key_length = shifts.size();
+        for (int k = 0; k < key_length; ++k) {
+            int32_t counts[32] = {};
+            for (int i = k; i < length; i += key_length) counts[text[i]]++;
+
+            int32_t best = INT32_MIN;
+            for (int s = 0; s < 26; ++s) {
+                const int32_t* ll_of = model.shifted(s);
+                int32_t ll = 0;
+                for (int x = 0; x < 32; ++x) ll += counts[x] * ll_of[x];
+                if (ll > best) { best = ll; shifts[k] = s; }
+            }
+        }
+    }
+
+    double score(const std::vector<uint8_t>& text, const std::vector<int>& shifts) {
+        int key_length = shifts.size();
+        for (int i = 0, k = 0; i < length; ++i) {
+            int x = text[i] - shifts[k];
+            plain[i] = static_cast<uint8_t>(x < 0 ? x + 26 : x);
+            if (++k == key_length) k = 0;
+        }
+        evaluation_count++;
+        return model.score(plain.data(), length);
+    }
+
+    // Blok van aangrenzende kolommen verplaatsen (bewaart kolomparen die al goed naast elkaar staan).
+    void blockMove(std::vector<int>& columns, Rng& rng) const {
+        int size = 1 + rng.below(std::max(1, width / 2));
+        int from = rng.below(width - size + 1);
+        std::vector<int> block(columns.begin() + from, columns.begin() + from + size);
+        columns.erase(columns.begin() + from, columns.begin() + from + size);
+        int to = rng.below(columns.size() + 1);
+        columns.insert(columns.begin() + to, block.begin(), block.end());
+    }
+
+    void remember(JointKey& best, const std::vector<int>& columns, const std::vector<int>& shifts, double score) {
+        best.perm.assign(width, 0);
+        for (int c = 0; c < width; ++c) best.perm[columns[c]] = c;
+        best.shifts = shifts;
+        best.score = score;
+    }
+
+    // Hill climbing vanuit het beste punt: elke sleutelletter alle 26 waarden, daarna alle
+    // kolomwissels, tot er niets meer verbetert.
+    void polish(JointKey& best) {
+        std::vector<int> columns(width);
+        for (int chunk = 0; chunk < width; ++chunk) columns[best.perm[chunk]] = chunk;
+        std::vector<int> shifts = best.shifts;
+        arrange(columns, arranged);
+        double current = score(arranged, shifts);
+
+        bool improved = true;
+        while (improved) {
+            improved = false;
+            for (size_t k = 0; k < shifts.size(); ++k) {
+                int keep = shifts[k];
+                for (int s = 0; s < 26; ++s) {
+                    if (s == keep) continue;
+                    shifts[k] = s;
+                    double next = score(arranged, shifts);
+                    if (next > current) { current = next; keep = s; improved = true; }
+                }
+                shifts[k] = keep;
+            }
+            for (int a = 0; a < width; ++a) {
+                for (int b = a + 1; b < width; ++b) {
+                    std::swap(columns[a], columns[b]);
+                    arrange(columns, candidate);
+                    double next = score(candidate, shifts);
+                    if (next > current) {
+                        current = next;
+                        arranged.swap(candidate);
+                        improved = true;
+                    } else {
+                        std::swap(columns[a], columns[b]);
+                    }
+                }
+            }
+        }
+        remember(best, columns, shifts, current);
+    }
+
+    const PlaintextModel& model;
+    int width;
+    int length;
+    int height;
+    int full_columns;
+    std::vector<uint8_t> letters;
+    std::vector<uint8_t> arranged;
+    std::vector<uint8_t> candidate;
+    std::vector<uint8_t> plain;
+    std::vector<int> starts;
+    std::vector<int> perm;
+    uint64_t evaluation_count = 0;
+};
+
+#endif // VIGINEREPLUS_JOINTANNEAL_H
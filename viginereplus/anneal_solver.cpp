@@ -0,0 +1,279 @@
+// Vigenère-plus via gezamenlijke simulated annealing (kolomvolgorde + Vigenère-sleutel).
+// Voor transpositiebreedtes 12..25, waar vigenereplus_solver niet alle permutaties kan aflopen.
+//
+//   g++ -std=c++17 -O3 -pthread anneal_solver.cpp -o anneal_solver
+//   ./anneal_solver                                   # opgave, Nederlands, breedtes 2-25
+//   ./anneal_solver --model english --widths 12-20 --in bericht.txt
+//   ./anneal_solver --selftest 12,16,20 --messages 10 # herstelgraad op testberichten uit data/corpus.txt
+//   ./anneal_solver --results runs                    # ook de top-K runs naar runs.jsonl en runs.bin
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+
+#include "Vigenere.h"
+#include "JointAnneal.h"
+#include "AnnealSearch.h"
+
+using namespace std;
+
+struct Range {
+    int first;
+    int last;
+};
+
+Range parse_range(const string& text) {
+    size_t dash = text.find('-');
+    if (dash == string::npos) return {stoi(text), stoi(text)};
+    return {stoi(text.substr(0, dash)), stoi(text.substr(dash + 1))};
+}
+
+string letters_only(const string& text) {
+    string out;
+    for (char c : text) {
+        if (isalpha(static_cast<unsigned char>(c))) out += static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    }
+    return out;
+}
+
+string read_file(const string& path) {
+    ifstream in(path);
+    if (!in) throw runtime_error("Kon bestand niet openen: " + path);
+    stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+// Testbericht: willekeurig stuk uit data/corpus.txt, willekeurige permutatie en sleutel.
+struct TestMessage {
+    string plain;
+    string cipher;
+    vector<int> perm;
+    string key;
+};
+
+TestMessage make_message(const string& corpus, int width, int key_length, int length, Rng& rng) {
+    TestMessage msg;
+    size_t offset = rng.below(static_cast<uint32_t>(corpus.size() - length + 1));
+    msg.plain = corpus.substr(offset, length);
+    msg.perm.resize(width);
+    iota(msg.perm.begin(), msg.perm.end(), 0);
+    rng.shuffle(msg.perm);
+    for (int i = 0; i < key_length; ++i) msg.key += static_cast<char>('A' + rng.below(26));
+    msg.cipher = encrypt_vigenereplus(msg.plain, msg.perm, msg.key);
+    return msg;
+}
+
+int main(int argc, char* argv[]) {
+    filesystem::path basePath = "../";
+    string model_name = "dutch";
+    string input_path = "01-OPGAVE-viginereplus.txt";
+    Range widths{2, 25};
+    Range key_lengths{1, 10};
+    int threads = max(1u, thread::hardware_concurrency());
+    double seconds_budget = 60.0;
+    uint64_t seed = randomSeed();
+    long iterations = 0;                  // 0 = afhankelijk van de breedte
+    double start_temperature = 20.0;
+    double end_temperature = 0.5;
+    string selftest;
+    int messages = 10;
+    int message_length = 1000;
+    int test_key_length = 7;
+    bool known_key_length = false;
+    string results_prefix;                // common/ResultRecord.h
+    size_t results_top = 10;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("Ontbrekende waarde voor " + arg);
+            return argv[++i];
+        };
+        try {
+            if (arg == "--model") model_name = value();
+            else if (arg == "--in") input_path = value();
+            else if (arg == "--widths") widths = parse_range(value());
+            else if (arg == "--key-lens") key_lengths = parse_range(value());
+            else if (arg == "--threads") threads = max(1, stoi(value()));
+            else if (arg == "--seconds") seconds_budget = stod(value());
+            else if (arg == "--seed") seed = stoull(value());
+            else if (arg == "--iterations") iterations = stol(value());
+            else if (arg == "--temperature") {
+                string t = value();
+                size_t dash = t.find('-');
+                start_temperature = stod(t.substr(0, dash));
+                if (dash != string::npos) end_temperature = stod(t.substr(dash + 1));
+            }
+            else if (arg == "--selftest") selftest = value();
+            else if (arg == "--messages") messages = stoi(value());
+            else if (arg == "--length") {
+                message_length = stoi(value());
+                if (message_length < 1) throw invalid_argument("moet minstens 1 zijn");
+            }
+            else if (arg == "--key-len") test_key_length = stoi(value());
+            else if (arg == "--known-key-len") known_key_length = true;
+            else if (arg == "--results") results_prefix = value();
+            else if (arg == "--results-top") results_top = stoul(value());
+            else {
+                cerr << "Onbekende optie: " << arg << endl;
+                return 1;
+            }
+        } catch (const exception& ex) {
+            cerr << "Ongeldige waarde voor " << arg << ": " << ex.what() << endl;
+            return 1;
+        }
+    }
+    if (widths.first < 2 || widths.last > 40 || widths.first > widths.last ||
+        key_lengths.first < 1 || key_lengths.first > key_lengths.last) {
+        cerr << "Ongeldig bereik voor --widths of --key-lens." << endl;
+        return 1;
+    }
+    if (!selftest.empty() && model_name == "dutch") model_name = "english";
+
+    unique_ptr<QuadgramScorer> scorer;
+    unique_ptr<PlaintextModel> model;
+    try {
+        if (model_name == "dutch") {
+            model = make_unique<PlaintextModel>(PlaintextModel::dutch());
+        } else {
+            scorer = make_unique<QuadgramScorer>((basePath / "data" / (model_name + "_quadgrams.txt")).string());
+            model = make_unique<PlaintextModel>(*scorer);
+        }
+    } catch (const exception& ex) {
+        cerr << ex.what() << endl;
+        return 1;
+    }
+
+    auto iterations_for = [&](int width) { return chain_iterations(width, iterations); };
+
+    if (selftest.empty()) {
+        string cipher;
+        try {
+            cipher = letters_only(read_file(input_path));
+        } catch (const exception& ex) {
+            cerr << ex.what() << endl;
+            return 1;
+        }
+
+        unique_ptr<ResultWriter> results;
+        try {
+            if (!results_prefix.empty()) results = make_unique<ResultWriter>(results_prefix);
+        } catch (const exception& ex) {
+            cerr << ex.what() << endl;
+            return 1;
+        }
+
+        SolveJob job;
+        job.cipher = &cipher;
+        job.model = model.get();
+        job.dutch = model_name == "dutch";
+        job.start_temperature = start_temperature;
+        job.end_temperature = end_temperature;
+        job.seconds_budget = seconds_budget;
+        if (results) job.candidates = ResultCandidates(results_top);
+        for (int w = widths.first; w <= widths.last; ++w) {
+            for (int l = key_lengths.first; l <= key_lengths.last; ++l) job.chains.push_back({w, l, iterations_for(w)});
+        }
+        cout << "Model " << model_name << ", breedtes " << widths.first << "-" << widths.last
+             << ", sleutellengtes " << key_lengths.first << "-" << key_lengths.last
+             << ", " << threads << " threads, seed " << seed << endl;
+        solve(job, threads, seed);
+
+        double seconds = elapsed(job);
+        cout << (job.solved ? "--- OPGELOST ---" : "--- BESTE KANDIDAAT (niet bevestigd) ---") << endl;
+        cout << "Breedte: " << job.best.perm.size() << endl;
+        cout << "Permutatie:";
+        for (int k : job.best.perm) cout << " " << k;
+        cout << endl;
+        cout << "Sleutel: " << job.best.vigenereKey() << endl;
+        cout << "Score: " << fixed << setprecision(2) << job.best.score << endl;
+        if (job.dutch) cout << "Taalcheck: " << setprecision(1) << dutch_word_density(job.best_plain) << endl;
+        cout << "Plaintext: " << job.best_plain << endl;
+        cerr << fixed << setprecision(3) << "Iteraties: " << job.evaluations << " in " << seconds << " s ("
+             << setprecision(0) << job.evaluations / max(seconds, 1e-9) << " it/s), " << job.runs_done << " runs" << endl;
+        if (results) {
+            ResultRecord record;
+            record.solver = "anneal_solver";
+            record.status = job.solved ? "solved" : "timeout";
+            record.model = model_name;
+            record.input = input_path;
+            record.seed = seed;
+            record.iterations = job.evaluations;
+            record.seconds = seconds;
+            record.addInfo("runs", job.runs_done);
+            record.addInfo("best_hits", job.best_hits);
+            record.top = job.candidates.ranked();
+            results->submit(move(record));
+            cerr << "Resultaatrecord naar: " << results->jsonPath() << " en " << results->binaryPath() << endl;
+        }
+        return job.solved ? 0 : 2;
+    }
+
+    // --- Zelftest: herstelgraad per breedte ---
+    string corpus;
+    try {
+        corpus = letters_only(read_file((basePath / "data" / "corpus.txt").string()));
+        if (static_cast<size_t>(message_length) > corpus.size()) {
+            throw invalid_argument("--length " + to_string(message_length) + " is langer dan data/corpus.txt (" +
+                                   to_string(corpus.size()) + " letters).");
+        }
+    } catch (const exception& ex) {
+        cerr << ex.what() << endl;
+        return 1;
+    }
+    vector<int> test_widths;
+    stringstream list(selftest);
+    for (string item; getline(list, item, ',');) test_widths.push_back(stoi(item));
+
+    Rng message_rng(seed);
+    cout << "Zelftest: model " << model_name << ", " << messages << " berichten van " << message_length
+         << " letters per breedte, sleutellengte " << test_key_length
+         << (known_key_length ? " (gekend)" : " (gezocht in " + to_string(key_lengths.first) + "-" + to_string(key_lengths.last) + ")")
+         << ", " << threads << " threads, max " << seconds_budget << " s per bericht, seed " << seed << endl;
+
+    for (int width : test_widths) {
+        int recovered = 0;
+        vector<double> times;
+        uint64_t evaluations = 0;
+        double total_seconds = 0;
+        for (int m = 0; m < messages; ++m) {
+            TestMessage msg = make_message(corpus, width, test_key_length, message_length, message_rng);
+            SolveJob job;
+            job.cipher = &msg.cipher;
+            job.model = model.get();
+            job.expected = &msg.plain;
+            job.start_temperature = start_temperature;
+            job.end_temperature = end_temperature;
+            job.seconds_budget = seconds_budget;
+            if (known_key_length) {
+                job.chains.push_back({width, test_key_length, iterations_for(width)});
+            } else {
+                for (int l = key_lengths.first; l <= key_lengths.last; ++l) job.chains.push_back({width, l, iterations_for(width)});
+            }
+            solve(job, threads, seed + m * 1000 + width);
+            total_seconds += elapsed(job);
+            evaluations += job.evaluations;
+            if (job.solved) {
+                recovered++;
+                times.push_back(job.solved_after);
+            }
+        }
+        sort(times.begin(), times.end());
+        cout << "breedte " << setw(2) << width << ": " << recovered << "/" << messages << " hersteld";
+        if (!times.empty()) cout << fixed << setprecision(2) << ", mediaan " << times[times.size() / 2] << " s";
+        cout << fixed << setprecision(0) << ", " << evaluations / max(total_seconds, 1e-9) << " evaluaties/s" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+// Microbenchmark: periodieke IC (sleutellengtes 1..10) met de oude string/vector-code
+// tegenover de histogramkernels uit common/PeriodicHistogram.h.
+//
+//   g++ -std=c++17 -O3 bench_ic.cpp -o bench_ic && ./bench_ic
+//
+// Elke kernel wordt eerst vergeleken met de referentie (bit-identieke scores), daarna getimed.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <chrono>
+#include <iomanip>
+
+#include "../common/PeriodicHistogram.h"
+
+using namespace std;
+
+// --- Referentie: de vroegere calculate_ic + score_vigenere_potential ---
+double reference_ic(const string& text) {
+    if (text.length() <= 1) return 0.0;
+    vector<int> counts(26, 0);
+    for (char c : text) counts[c - 'A']++;
+
+    double sum = 0;
+    for (int c : counts) sum += c * (c - 1);
+
+    return sum / (text.length() * (text.length() - 1));
+}
+
+double reference_score(const string& text) {
+    double max_avg_ic = 0.0;
+    for (int key_len = 1; key_len <= 10; ++key_len) {
+        double total_ic = 0.0;
+        for (int i = 0; i < key_len; ++i) {
+            string slice;
+            for (size_t j = i; j < text.length(); j += key_len) slice += text[j];
+            total_ic += reference_ic(slice);
+        }
+        double avg_ic = total_ic / key_len;
+        if (avg_ic > max_avg_ic) max_avg_ic = avg_ic;
+    }
+    return max_avg_ic;
+}
+
+double kernel_score(const string& text, HistogramKernel kernel) {
+    PeriodicHistograms hist;
+    periodicHistograms(text, hist, kernel);
+    double avg_ic[PeriodicHistograms::MAX_PERIOD + 1];
+    periodICs(hist, avg_ic);
+    return *max_element(avg_ic + 1, avg_ic + PeriodicHistograms::MAX_PERIOD + 1);
+}
+
+template <typename Score>
+double time_ns_per_text(const vector<string>& texts, int reps, Score score, double& checksum) {
+    checksum = 0.0;
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        for (const auto& t : texts) checksum += score(t);
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    return ns / (static_cast<double>(reps) * texts.size());
+}
+
+int main() {
+    ifstream in("01-OPGAVE-viginereplus.txt");
+    if (!in) {
+        cerr << "Kon 01-OPGAVE-viginereplus.txt niet openen (run vanuit viginereplus/)." << endl;
+        return 1;
+    }
+    string cipher((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    cipher.erase(remove_if(cipher.begin(), cipher.end(), [](char c) { return c < 'A' || c > 'Z'; }), cipher.end());
+
+    vector<HistogramKernel> kernels = {HistogramKernel::Scalar, HistogramKernel::AVX2, HistogramKernel::AVX512};
+    mt19937 rng(12345);
+
+    // Twee werklasten: willekeurige herschikkingen van de opgave (plus kortere stukken voor de
+    // staartbehandeling), en lange teksten waar de vaste kost per oproep niet meer meetelt.
+    for (int workload = 0; workload < 2; ++workload) {
+        vector<string> texts;
+        int count = workload == 0 ? 256 : 8;
+        for (int i = 0; i < count; ++i) {
+            string t;
+            do {
+                string part = cipher;
+                shuffle(part.begin(), part.end(), rng);
+                t += part;
+            } while (workload == 1 && t.size() < 100000);
+            if (workload == 0 && i % 4 == 1) t.resize(t.size() / 3 + i % 61);
+            texts.push_back(t);
+        }
+
+        for (HistogramKernel k : kernels) {
+            if (!histogramKernelSupported(k)) continue;
+            for (const auto& t : texts) {
+                if (kernel_score(t, k) != reference_score(t)) {
+                    cerr << "FOUT: kernel " << histogramKernelName(k) << " wijkt af van de referentie." << endl;
+                    return 1;
+                }
+            }
+        }
+
+        const int REPS = workload == 0 ? 20 : 5;
+        double bytes = 0;
+        for (const auto& t : texts) bytes += t.size();
+        bytes /= texts.size();
+
+        double checksum;
+        double ref_ns = time_ns_per_text(texts, REPS, reference_score, checksum);
+        cout << fixed << setprecision(1);
+        cout << "Tekstlengte gemiddeld " << bytes << " tekens, scores identiek voor alle kernels." << endl;
+        cout << "  " << left << setw(10) << "referentie" << right << setw(12) << ref_ns << " ns/tekst  "
+             << setw(6) << ref_ns / bytes << " ns/teken" << endl;
+        for (HistogramKernel k : kernels) {
+            if (!histogramKernelSupported(k)) {
+                cout << "  " << left << setw(10) << histogramKernelName(k) << right << "  niet ondersteund" << endl;
+                continue;
+            }
+            double ns = time_ns_per_text(texts, REPS, [k](const string& t) { return kernel_score(t, k); }, checksum);
+            cout << "  " << left << setw(10) << histogramKernelName(k) << right << setw(12) << ns << " ns/tekst  "
+                 << setw(6) << ns / bytes << " ns/teken  (x" << ref_ns / ns << ")"
+                 << (k == bestHistogramKernel() ? "  <- gekozen" : "") << endl;
+        }
+    }
+    return 0;
+}
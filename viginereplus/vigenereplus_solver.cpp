@@ -9,6 +9,21 @@
 #include <cmath>
 #include <iomanip>
 #include <stdexcept>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <set>
+#include <condition_variable>
+
+#include "../common/Permutation.h"
+#include "../common/ShardFile.h"
+#include "../common/PeriodicHistogram.h"
+#include "../common/ResultRecord.h"
+#include "Vigenere.h"
+#include "ColumnarIC.h"
+#include "PrefixSearch.h"
 
 using namespace std;
 
@@ -21,173 +36,564 @@ string load_ciphertext(const string& path) {
     return string((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
 }
 
-// Nederlandse letterfrequenties (A=0, B=1, ...)
-const double DUTCH_FREQ[26] = {
-    7.49, 1.58, 1.24, 5.93, 18.91, 0.81, 3.40, 2.38, 6.50, 1.46, 2.25, 3.57, 2.21,
-    10.03, 6.06, 1.57, 0.01, 6.41, 3.73, 6.79, 1.99, 2.85, 1.52, 0.04, 0.03, 1.39
+// Score hoe "Vigenere-achtig" de tekst is.
+// Als de transpositie goed is, moeten de periodieke slices een hoge IC hebben (NL ~0.077)
+// Als de transpositie fout is, is het random (~0.038)
+// De histogrammen van alle slices van sleutellengtes 1 t/m 10 komen uit één vectorkernel.
+double score_vigenere_potential(const string& text) {
+    PeriodicHistograms hist;
+    periodicHistograms(text, hist);
+    double avg_ic[PeriodicHistograms::MAX_PERIOD + 1];
+    periodICs(hist, avg_ic);
+
+    double max_avg_ic = 0.0;
+    for (int key_len = 1; key_len <= 10; ++key_len) {
+        if (avg_ic[key_len] > max_avg_ic) max_avg_ic = avg_ic[key_len];
+    }
+    return max_avg_ic;
+}
+
+string solve_vigenere(const string& text) {
+    VigenereSolution solution = crack_vigenere(text);
+    return "\n=== KEY: " + solution.key + " ===\n\n" + solution.plaintext
+        + "\n\n=============================================";
+}
+
+const int MIN_WIDTH = 2;
+const double HIT_THRESHOLD = 0.077;
+
+// Grootste breedte die nog af raakt: exhaustief ~11 µs per permutatie (breedte 12 ≈ 1.5 core-uur),
+// met --prefix ~5 µs per blad (breedte 13 ≈ 6 miljard bladeren ≈ 9 core-uren, te verdelen met --shard).
+// Daarboven is enkel anneal_solver haalbaar.
+const int MAX_WIDTH_EXHAUSTIVE = 12;
+const int MAX_WIDTH_PREFIX = 13;
+
+// Grootste transpositiebreedte (--max-width) en zoekmodus (--prefix: prefix-zoektocht), vastgelegd in main.
+int max_width = 10;
+bool use_prefix = false;
+
+// --mode stream:     elke hit boven HIT_THRESHOLD meteen met volledige decryptie (standaard)
+// --mode ranked:     alles doorzoeken, op het einde een gerangschikte top-K
+// --mode first:      stoppen zodra een kandidaat de taalcheck haalt
+enum class OutputMode { Stream, Ranked, First };
+OutputMode output_mode = OutputMode::Stream;
+
+// Exhaustief is een eenheid van de sleutelruimte één permutatie. Met --prefix (prefix-zoektocht) is
+// het een prefix (de eerste 2 kolommen, vanaf breedte 12 de eerste 3) waarvan de deelboom in
+// één keer doorzocht wordt; prefixen staan in lexicografische volgorde, dus de bladeren komen
+// in dezelfde volgorde als bij de exhaustieve zoektocht.
+int prefix_depth(int width) {
+    return min(width, width >= 12 ? 3 : 2);
+}
+
+uint64_t units_for_width(int width) {
+    if (!use_prefix) return factorial(width);
+    return factorial(width) / factorial(width - prefix_depth(width));
+}
+
+// De volledige sleutelruimte is de aaneenschakeling van alle breedtes 2 t/m max_width, per breedte
+// in next_permutation-volgorde. Een globale rang bepaalt dus (breedte, lokale rang).
+uint64_t keyspace_size() {
+    uint64_t total = 0;
+    for (int w = MIN_WIDTH; w <= max_width; ++w) total += units_for_width(w);
+    return total;
+}
+
+uint64_t width_offset(int width) {
+    uint64_t offset = 0;
+    for (int w = MIN_WIDTH; w < width; ++w) offset += units_for_width(w);
+    return offset;
+}
+
+// Shard-bestanden van verschillende modi of breedtes mogen niet door elkaar gebruikt worden.
+string solver_name() {
+    string name = use_prefix ? "vigenereplus_prefix" : "vigenereplus";
+    if (max_width != 10) name += "_w" + to_string(max_width);
+    return name;
+}
+
+void print_hit(const string& text, const vector<int>& p, double score) {
+    cout << "\n[!] Mogelijke hit gevonden!" << endl;
+    cout << "Transpositie Breedte: " << p.size() << endl;
+    cout << "Transpositie Permutatie: ";
+    for(int k : p) cout << k << " ";
+    cout << endl;
+    cout << "IC Score: " << score << endl;
+
+    // Probeer Vigenere op te lossen en print resultaat
+    cout << solve_vigenere(decrypt_columnar(text, p)) << endl;
+}
+
+struct Hit {
+    uint64_t rank;
+    vector<int> key;
+    double score;
+};
+
+// Resultaat van één blok, in volgorde van rang.
+struct BlockOutput {
+    bool ready = false;
+    vector<Hit> hits;
+    TopK top;
+    uint64_t tested = 0;
 };
 
+// Verwerkt de globale rangen [begin, end): per breedte één keer unranken, daarna next_permutation.
+// `scorers` is een per-thread cache met één ColumnarICScorer per breedte.
+void search_range(const string& text, uint64_t begin, uint64_t end,
+                  vector<unique_ptr<ColumnarICScorer>>& scorers, BlockOutput& out) {
+    for (int width = MIN_WIDTH; width <= max_width && begin < end; ++width) {
+        uint64_t w_begin = width_offset(width);
+        uint64_t w_end = w_begin + factorial(width);
+        if (begin >= w_end) continue;
 
-// 1. Transpositie ongedaan maken
-string decrypt_columnar(const string& cipher, const vector<int>& key) {
-    int len = cipher.length();
-    int width = key.size();
-    int height = (len + width - 1) / width; // ceil(len/width)
-    int num_full_cols = len % width;
-    if (num_full_cols == 0) num_full_cols = width;
-
-    // Grid buffers voor elke kolom
-    vector<string> grid(width);
-    
-    int current_pos = 0;
-    // De 'key' bevat de volgorde waarin de kolommen zijn uitgelezen.
-    // We itereren door de sleutel om de chunks uit de ciphertext te halen.
-    for (int k : key) {
-        // Een fysieke kolom 'k' is lang als k < num_full_cols, anders kort
-        int col_len = (k < num_full_cols) ? height : height - 1;
-        grid[k] = cipher.substr(current_pos, col_len);
-        current_pos += col_len;
-    }
-
-    // Nu lezen we het rij voor rij uit
-    string plain;
-    plain.reserve(len);
-    for (int r = 0; r < height; ++r) {
-        for (int c = 0; c < width; ++c) {
-            if (r < grid[c].length()) {
-                plain += grid[c][r];
+        uint64_t stop = min(end, w_end);
+        vector<int> p = permutationFromRank(width, begin - w_begin);
+        // Zelfde score als score_vigenere_potential(decrypt_columnar(text, p)), maar zonder tussentekst.
+        if (!scorers[width]) scorers[width] = make_unique<ColumnarICScorer>(text, width);
+        ColumnarICScorer& ic_scorer = *scorers[width];
+        for (uint64_t rank = begin; rank < stop; ++rank) {
+            // Filter: Is dit een valide Vigenere tekst?
+            // Nederlandse Vigenere heeft IC rond 0.077 in kolommen. Random is 0.038.
+            double score = ic_scorer.score(p);
+            out.top.add({score, p});
+
+            if (score > HIT_THRESHOLD) { // Strenge filter
+                out.hits.push_back({rank, p, score});
             }
+            next_permutation(p.begin(), p.end());
         }
+        out.tested += stop - begin;
+        begin = stop;
     }
-    return plain;
 }
 
-// Helper voor IC (Index of Coincidence)
-double calculate_ic(const string& text) {
-    if (text.length() <= 1) return 0.0;
-    vector<int> counts(26, 0);
-    for (char c : text) counts[c - 'A']++;
-    
-    double sum = 0;
-    for (int c : counts) sum += c * (c - 1);
-    
-    return sum / (text.length() * (text.length() - 1));
+// Prefix-variant van search_range (--prefix): elke rang in [begin, end) is een prefix, waarvan
+// PrefixICSearch de volledige deelboom scoort. Scores, hits en top-K zijn dezelfde als exhaustief.
+void search_prefixes(const string& text, uint64_t begin, uint64_t end,
+                     vector<unique_ptr<PrefixICSearch>>& searchers, BlockOutput& out) {
+    for (int width = MIN_WIDTH; width <= max_width && begin < end; ++width) {
+        uint64_t w_begin = width_offset(width);
+        uint64_t w_end = w_begin + units_for_width(width);
+        if (begin >= w_end) continue;
+
+        uint64_t stop = min(end, w_end);
+        if (!searchers[width]) searchers[width] = make_unique<PrefixICSearch>(text, width);
+        PrefixICSearch& searcher = *searchers[width];
+        int depth = prefix_depth(width);
+        uint64_t leaves_before = searcher.leaves_scored;
+        for (uint64_t rank = begin; rank < stop; ++rank) {
+            // Het prefix met lokale rang i is het begin van de permutatie met rang i * (width - depth)!.
+            vector<int> prefix = permutationFromRank(width, (rank - w_begin) * factorial(width - depth));
+            prefix.resize(depth);
+            searcher.search(prefix, [&](const vector<int>& p, double score) {
+                out.top.add({score, p});
+                if (score > HIT_THRESHOLD) out.hits.push_back({rank, p, score});
+            });
+        }
+        out.tested += searcher.leaves_scored - leaves_before;
+        begin = stop;
+    }
 }
 
-// Score hoe "Vigenere-achtig" de tekst is.
-// Als de transpositie goed is, moeten de periodieke slices een hoge IC hebben (NL ~0.077)
-// Als de transpositie fout is, is het random (~0.038)
-double score_vigenere_potential(const string& text) {
-    double max_avg_ic = 0.0;
-    
-    // We checken mogelijke Vigenere sleutellengtes 2 t/m 10
-    for (int key_len = 1; key_len <= 10; ++key_len) {
-        double total_ic = 0.0;
-        for (int i = 0; i < key_len; ++i) {
-            string slice;
-            for (int j = i; j < text.length(); j += key_len) {
-                slice += text[j];
+// Gedeelde toestand van de parallelle zoektocht. Threads nemen dynamisch het volgende blok
+// (over alle breedtes heen); afgewerkte blokken worden strikt in rangvolgorde "gecommit"
+// (hits printen, shard-toestand bijwerken), zodat de output niet van het aantal threads afhangt.
+// --mode first: begrensde top-K van hits (op IC), waarvan een achtergrondthread telkens de beste
+// nog niet afgewerkte kandidaat ontcijfert en door de taalcheck haalt.
+struct EarlyStop {
+    mutex m;
+    condition_variable changed;
+    TopK candidates;
+    set<vector<int>> finished;
+    bool search_done = false;
+
+    bool solved = false;
+    ShardCandidate solution_candidate;
+    VigenereSolution solution;
+    double confidence = 0.0;
+    double seconds = 0.0;
+};
+
+struct ParallelSearch {
+    const string* text;
+    atomic<bool> stop{false};
+    EarlyStop early;
+    vector<uint64_t> pending_blocks;
+    atomic<size_t> next_pending{0};
+
+    mutex commit_mutex;
+    vector<BlockOutput> outputs;    // index in pending_blocks
+    size_t next_commit = 0;
+
+    ShardState* state;
+    string state_path;
+    double resumed_seconds = 0.0;
+    chrono::steady_clock::time_point started;
+};
+
+// Moet onder commit_mutex aangeroepen worden.
+void commit_ready_blocks(ParallelSearch& search) {
+    while (search.next_commit < search.pending_blocks.size() && search.outputs[search.next_commit].ready) {
+        BlockOutput& out = search.outputs[search.next_commit];
+        uint64_t block = search.pending_blocks[search.next_commit];
+        ShardState& state = *search.state;
+
+        // Hits en "klaar met breedte"-meldingen in rangvolgorde, net als bij een sequentiële run.
+        auto emit = [&](const Hit& hit) {
+            if (output_mode == OutputMode::Stream) {
+                print_hit(*search.text, hit.key, hit.score);
+            } else if (output_mode == OutputMode::First) {
+                lock_guard<mutex> lock(search.early.m);
+                search.early.candidates.add({hit.score, hit.key});
+                search.early.changed.notify_one();
             }
-            total_ic += calculate_ic(slice);
+        };
+        auto [block_begin, block_end] = state.blockRange(block);
+        size_t h = 0;
+        for (int width = MIN_WIDTH; width <= max_width; ++width) {
+            uint64_t width_end = width_offset(width) + units_for_width(width);
+            if (width_end <= block_begin || width_end > block_end) continue;
+            for (; h < out.hits.size() && out.hits[h].rank < width_end; ++h) emit(out.hits[h]);
+            cout << "Klaar met breedte " << width << "..." << endl;
+        }
+        for (; h < out.hits.size(); ++h) emit(out.hits[h]);
+
+        state.top.merge(out.top);
+        state.counters["permutations_tested"] += out.tested;
+        state.counters["hits"] += out.hits.size();
+        state.done_blocks[block] = true;
+        state.elapsed_seconds = search.resumed_seconds +
+                chrono::duration<double>(chrono::steady_clock::now() - search.started).count();
+        if (!search.state_path.empty()) saveShardState(state, search.state_path);
+
+        out = BlockOutput();  // geheugen vrijgeven
+        search.next_commit++;
+    }
+}
+
+void search_worker(ParallelSearch* search) {
+    vector<unique_ptr<ColumnarICScorer>> scorers(max_width + 1);
+    vector<unique_ptr<PrefixICSearch>> searchers(max_width + 1);
+    while (!search->stop.load(memory_order_relaxed)) {
+        size_t i = search->next_pending++;
+        if (i >= search->pending_blocks.size()) break;
+        auto [begin, end] = search->state->blockRange(search->pending_blocks[i]);
+
+        BlockOutput out;
+        out.top = TopK(search->state->top.capacity());
+        if (use_prefix) {
+            search_prefixes(*search->text, begin, end, searchers, out);
+        } else {
+            search_range(*search->text, begin, end, scorers, out);
         }
-        double avg_ic = total_ic / key_len;
-        if (avg_ic > max_avg_ic) max_avg_ic = avg_ic;
+        out.ready = true;
+
+        lock_guard<mutex> lock(search->commit_mutex);
+        search->outputs[i] = move(out);
+        commit_ready_blocks(*search);
     }
-    return max_avg_ic;
 }
 
-// Vigenere kraker (frequentie analyse per kolom)
-string solve_vigenere(const string& text) {
-    string decrypted = text;
-    string best_key = "";
-    
-    // Bepaal eerst de beste sleutellengte o.b.v. IC
-    int best_len = 1;
-    double best_ic = 0;
-    for (int l = 1; l <= 10; ++l) {
-         double total_ic = 0.0;
-        for (int i = 0; i < l; ++i) {
-            string slice;
-            for (int j = i; j < text.length(); j += l) slice += text[j];
-            total_ic += calculate_ic(slice);
+// Achtergrondthread voor --mode first: ontcijfert de beste nog niet geteste kandidaat en zet
+// de zoektocht stop zodra er een de taalcheck haalt.
+void finish_candidates(ParallelSearch* search) {
+    EarlyStop& early = search->early;
+    unique_lock<mutex> lock(early.m);
+    while (!early.solved) {
+        const ShardCandidate* next = nullptr;
+        for (const auto& c : early.candidates.ranked()) {
+            if (!early.finished.count(c.key)) { next = &c; break; }
         }
-        double avg = total_ic / l;
-        if (avg > best_ic) { best_ic = avg; best_len = l; }
-    }
-
-    // Nu per kolom de caesar shift bepalen (Chi-squared)
-    for (int i = 0; i < best_len; ++i) {
-        string slice;
-        for (int j = i; j < text.length(); j += best_len) slice += text[j];
-        
-        int best_shift = 0;
-        double min_chi = 1e9;
-        
-        for (int shift = 0; shift < 26; ++shift) {
-            double chi = 0;
-            vector<int> counts(26, 0);
-            for (char c : slice) counts[(c - 'A' - shift + 26) % 26]++;
-            
-            for (int k = 0; k < 26; ++k) {
-                double expected = DUTCH_FREQ[k] * slice.length() / 100.0;
-                double diff = counts[k] - expected;
-                chi += (diff * diff) / expected;
-            }
-            if (chi < min_chi) { min_chi = chi; best_shift = shift; }
+        if (!next) {
+            if (early.search_done) break;
+            early.changed.wait(lock);
+            continue;
+        }
+        ShardCandidate candidate = *next;
+        early.finished.insert(candidate.key);
+
+        lock.unlock();
+        VigenereSolution solution = crack_vigenere(decrypt_columnar(*search->text, candidate.key));
+        double confidence = dutch_word_density(solution.plaintext);
+        lock.lock();
+
+        if (confidence >= LANGUAGE_CONFIDENCE_THRESHOLD) {
+            early.solved = true;
+            early.solution_candidate = candidate;
+            early.solution = solution;
+            early.confidence = confidence;
+            early.seconds = chrono::duration<double>(chrono::steady_clock::now() - search->started).count();
+            search->stop = true;
+        }
+    }
+}
+
+// Gerangschikte lijst (--mode ranked): per kandidaat de Vigenère-sleutel en de taalcheck,
+// daarna de volledige plaintext van de overtuigendste kandidaat.
+void print_ranked(const string& text, const vector<ShardCandidate>& ranked) {
+    cout << "\nTop " << ranked.size() << " kandidaten (IC, taalcheck = Nederlandse woorden per 100 letters):" << endl;
+    const ShardCandidate* best = nullptr;
+    VigenereSolution best_solution;
+    double best_confidence = 0.0;
+    for (size_t i = 0; i < ranked.size(); ++i) {
+        VigenereSolution solution = crack_vigenere(decrypt_columnar(text, ranked[i].key));
+        double confidence = dutch_word_density(solution.plaintext);
+        cout << " #" << i + 1 << ": IC = " << ranked[i].score << " | Breedte " << ranked[i].key.size() << " | Permutatie: ";
+        for (int k : ranked[i].key) cout << k << " ";
+        cout << "| Sleutel " << solution.key << " | Taalcheck " << fixed << setprecision(2) << confidence
+             << defaultfloat << setprecision(6) << endl;
+        if (confidence > best_confidence) {
+            best = &ranked[i];
+            best_solution = solution;
+            best_confidence = confidence;
         }
-        best_key += (char)('A' + best_shift);
     }
+    if (best && best_confidence >= LANGUAGE_CONFIDENCE_THRESHOLD) {
+        cout << "\nBeste kandidaat volgens de taalcheck: Permutatie ";
+        for (int k : best->key) cout << k << " ";
+        cout << "(IC " << best->score << ")" << endl;
+        cout << "\n=== KEY: " << best_solution.key << " ===\n\n" << best_solution.plaintext
+             << "\n\n=============================================" << endl;
+    } else {
+        cout << "\nGeen enkele kandidaat haalt de taalcheck (drempel " << LANGUAGE_CONFIDENCE_THRESHOLD << ")." << endl;
+    }
+}
 
-    // Decrypt met gevonden sleutel
-    for (int i = 0; i < text.length(); ++i) {
-        int shift = best_key[i % best_len] - 'A';
-        decrypted[i] = (text[i] - 'A' - shift + 26) % 26 + 'A';
+// Gestructureerde record (--results): de top-K transposities op IC, elk met de Vigenère-sleutel en
+// plaintext uit crack_vigenere. De iteraties zijn de geteste permutaties; er is geen seed.
+void write_results(const string& prefix, size_t top, const string& text, const string& status,
+                   const vector<ShardCandidate>& ranked, uint64_t permutations_tested, double seconds) {
+    ResultRecord record;
+    record.solver = "vigenereplus_solver";
+    record.status = status;
+    record.model = "ic";
+    record.input = "01-OPGAVE-viginereplus.txt";
+    record.iterations = permutations_tested;
+    record.seconds = seconds;
+    record.addInfo("max_width", max_width);
+    for (size_t i = 0; i < min(top, ranked.size()); ++i) {
+        VigenereSolution solution = crack_vigenere(decrypt_columnar(text, ranked[i].key));
+        record.top.push_back({ranked[i].score, keyText(ranked[i].key) + " | " + solution.key, solution.plaintext});
     }
-    
-        return "\n=== KEY: " + best_key + " ===\n\n" + decrypted 
-        + "\n\n=============================================";
+    ResultWriter results(prefix);
+    results.submit(move(record));
+    cout << "Resultaatrecord naar: " << results.jsonPath() << " en " << results.binaryPath() << endl;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Threads:     --threads N (standaard: alle hardware-threads)
+    // Zoekruimte:  --max-width W (standaard 10), --prefix voor de prefix-zoektocht i.p.v. exhaustief
+    // Uitvoer:     --mode stream|ranked|first (zie OutputMode)
+    // Sharding:    --shard i/N [--out bestand] [--top K]   (herstartbaar via het shard-bestand)
+    // Samenvoegen: --merge shard0.txt shard1.txt ...
+    // Pipeline:    --results PREFIX [--results-top K]  (PREFIX.jsonl en PREFIX.bin, common/ResultRecord.h)
+    ShardSpec shard;
+    bool sharded = false;
+    string out_path;
+    size_t top_k = 100;
+    string results_prefix;
+    size_t results_top = 10;
+    unsigned int num_threads = thread::hardware_concurrency();
+    if (num_threads == 0) num_threads = 1;
+    vector<string> merge_paths;
     string text;
     try {
+        for (int a = 1; a < argc; ++a) {
+            string arg = argv[a];
+            if (arg == "--shard" && a + 1 < argc) {
+                shard = parseShardSpec(argv[++a]);
+                sharded = true;
+            } else if (arg == "--out" && a + 1 < argc) {
+                out_path = argv[++a];
+            } else if (arg == "--top" && a + 1 < argc) {
+                top_k = stoul(argv[++a]);
+            } else if (arg == "--threads" && a + 1 < argc) {
+                num_threads = max(1, stoi(argv[++a]));
+            } else if (arg == "--max-width" && a + 1 < argc) {
+                max_width = stoi(argv[++a]);
+            } else if (arg == "--mode" && a + 1 < argc) {
+                string mode = argv[++a];
+                if (mode == "stream") output_mode = OutputMode::Stream;
+                else if (mode == "ranked") output_mode = OutputMode::Ranked;
+                else if (mode == "first") output_mode = OutputMode::First;
+                else throw invalid_argument("Onbekende modus: " + mode + " (stream, ranked of first)");
+            } else if (arg == "--results" && a + 1 < argc) {
+                results_prefix = argv[++a];
+            } else if (arg == "--results-top" && a + 1 < argc) {
+                results_top = stoul(argv[++a]);
+            } else if (arg == "--prefix") {
+                use_prefix = true;
+            } else if (arg == "--merge") {
+                while (a + 1 < argc) merge_paths.push_back(argv[++a]);
+            } else {
+                throw invalid_argument("Onbekend argument: " + arg +
+                    " (gebruik: [--threads N] [--max-width W] [--prefix] [--mode stream|ranked|first] [--shard i/N [--out bestand] [--top K]] [--results prefix [--results-top K]] | --merge bestanden...)");
+            }
+        }
+        int width_limit = use_prefix ? MAX_WIDTH_PREFIX : MAX_WIDTH_EXHAUSTIVE;
+        if (max_width < MIN_WIDTH || max_width > width_limit) {
+            throw invalid_argument("--max-width moet tussen 2 en " + to_string(width_limit) + " liggen" +
+                                   (use_prefix ? "" : " (met --prefix tot " + to_string(MAX_WIDTH_PREFIX) + ")") +
+                                   "; voor grotere breedtes: anneal_solver.");
+        }
         text = load_ciphertext("01-OPGAVE-viginereplus.txt");
     } catch (const exception& ex) {
         cerr << ex.what() << endl;
         return 1;
     }
 
-    cout << "Start kraken (dit kan enkele minuten duren)..." << endl;
-
-    // Probeer elke transpositie sleutel lengte
-    for (int width = 2; width <= 10; ++width) {
-        vector<int> p(width);
-        iota(p.begin(), p.end(), 0); // Vul met 0, 1, 2...
+    if (!merge_paths.empty()) {
+        try {
+            MergedShards merged = mergeShardFiles(merge_paths, solver_name());
+            cout << "--- SHARDS SAMENGEVOEGD ---" << endl;
+            cout << merged.shards_seen << " van " << merged.shard_count << " shards, "
+                 << merged.counters["permutations_tested"] << " permutaties getest, "
+                 << merged.counters["hits"] << " hits, rekentijd " << merged.total_seconds
+                 << " s (traagste shard " << merged.slowest_shard_seconds << " s)." << endl;
+            if (merged.shards_seen < merged.shard_count || merged.incomplete_shards > 0) {
+                cout << "LET OP: " << merged.shard_count - merged.shards_seen << " shard(s) ontbreken en "
+                     << merged.incomplete_shards << " shard(s) zijn nog niet klaar; de ranking is onvolledig." << endl;
+            }
 
-        // Probeer elke permutatie
-        do {
-            string trans_candidate = decrypt_columnar(text, p);
-            
-            // Filter: Is dit een valide Vigenere tekst?
-            // Nederlandse Vigenere heeft IC rond 0.077 in kolommen. Random is 0.038.
-            // We zetten de drempel op 0.065 om ruis eruit te filteren.
-            double score = score_vigenere_potential(trans_candidate);
-            
-            if (score > 0.077) { // Strenge filter
-                cout << "\n[!] Mogelijke hit gevonden!" << endl;
-                cout << "Transpositie Breedte: " << width << endl;
-                cout << "Transpositie Permutatie: ";
-                for(int k : p) cout << k << " ";
+            const auto& ranked = merged.top.ranked();
+            if (!results_prefix.empty()) {
+                write_results(results_prefix, results_top, text, "merged", ranked,
+                              merged.counters["permutations_tested"], merged.total_seconds);
+            }
+            if (output_mode == OutputMode::Ranked) {
+                print_ranked(text, ranked);
+                return 0;
+            }
+            cout << "\nTop " << min<size_t>(10, ranked.size()) << " kandidaten (IC):" << endl;
+            for (size_t i = 0; i < min<size_t>(10, ranked.size()); ++i) {
+                cout << " #" << i + 1 << ": IC = " << ranked[i].score << " | Breedte " << ranked[i].key.size() << " | Permutatie: ";
+                for (int k : ranked[i].key) cout << k << " ";
                 cout << endl;
-                cout << "IC Score: " << score << endl;
-                
-                // Probeer Vigenere op te lossen en print resultaat
-                cout << solve_vigenere(trans_candidate) << endl;
             }
+            for (const auto& c : ranked) {
+                if (c.score > HIT_THRESHOLD) print_hit(text, c.key, c.score);
+            }
+        } catch (const exception& ex) {
+            cerr << ex.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (sharded && out_path.empty()) {
+        out_path = "shard_" + to_string(shard.index) + "_of_" + to_string(shard.count) + ".txt";
+    }
+
+    // Zonder --shard is dit gewoon shard 0/1 zonder resultaatbestand.
+    // Met --prefix is een blok één prefix (een volledige deelboom).
+    const uint64_t BLOCK_SIZE = use_prefix ? 1 : 1 << 12;
+    ShardState state = newShardState(solver_name(), keyspace_size(), shard, BLOCK_SIZE, top_k);
+    // Breedte en zoekmodus zitten al in de solvernaam; de IC's hangen verder enkel van de ciphertext af.
+    state.settings = "ciphertext=" + textFingerprint(text);
+    double resumed_seconds = 0.0;
+    if (!out_path.empty()) {
+        ShardState previous;
+        if (loadShardState(out_path, previous)) {
+            if (!sameShardLayout(previous, state)) {
+                cerr << "Bestaand shard-bestand " << out_path << " hoort bij een andere shard-configuratie." << endl;
+                return 1;
+            }
+            if (!sameShardSettings(previous, state)) {
+                cerr << settingsMismatch(out_path, previous.settings, state.settings) << endl;
+                return 1;
+            }
+            state = previous;
+            resumed_seconds = previous.elapsed_seconds;
+            cout << "Hervatten vanuit " << out_path << endl;
+        }
+    }
+
+    cout << "Start kraken (dit kan enkele minuten duren)..." << endl;
+    if (sharded) {
+        cout << "Shard " << shard.index << "/" << shard.count << ": rangen " << state.range_begin
+             << "-" << state.range_end - 1 << " van " << keyspace_size() << "." << endl;
+    }
+
+    ParallelSearch search;
+    search.text = &text;
+    search.state = &state;
+    search.state_path = out_path;
+    search.resumed_seconds = resumed_seconds;
+    for (uint64_t b = 0; b < state.numBlocks(); ++b) {
+        if (!state.done_blocks[b]) search.pending_blocks.push_back(b);
+    }
+    search.outputs.resize(search.pending_blocks.size());
+
+    unsigned int threads_to_use = max<unsigned int>(1, min<size_t>(num_threads, search.pending_blocks.size()));
+    // Naar stderr: stdout is byte-identiek ongeacht het aantal threads.
+    cerr << "Gebruik " << threads_to_use << " thread(s) voor " << search.pending_blocks.size()
+         << " blokken van " << BLOCK_SIZE << (use_prefix ? " prefix." : " permutaties.") << endl;
+
+    search.started = chrono::steady_clock::now();
+    search.early.candidates = TopK(top_k);
+    thread finisher;
+    if (output_mode == OutputMode::First) finisher = thread(finish_candidates, &search);
+    vector<thread> threads;
+    for (unsigned int i = 0; i < threads_to_use; ++i) {
+        threads.emplace_back(search_worker, &search);
+    }
+    for (auto& t : threads) t.join();
+    if (finisher.joinable()) {
+        {
+            lock_guard<mutex> lock(search.early.m);
+            search.early.search_done = true;
+        }
+        search.early.changed.notify_one();
+        finisher.join();
+    }
+
+    if (output_mode == OutputMode::First) {
+        EarlyStop& early = search.early;
+        if (early.solved) {
+            cout << "\nOplossing gevonden na " << fixed << setprecision(2) << early.seconds << defaultfloat
+                 << setprecision(6) << " s (" << state.counters["permutations_tested"] << " permutaties getest, "
+                 << early.finished.size() << " kandidaten ontcijferd)." << endl;
+            cout << "Transpositie Breedte: " << early.solution_candidate.key.size() << endl;
+            cout << "Transpositie Permutatie: ";
+            for (int k : early.solution_candidate.key) cout << k << " ";
+            cout << endl;
+            cout << "IC Score: " << early.solution_candidate.score << endl;
+            cout << "Taalcheck: " << early.confidence << " Nederlandse woorden per 100 letters" << endl;
+            cout << "\n=== KEY: " << early.solution.key << " ===\n\n" << early.solution.plaintext
+                 << "\n\n=============================================" << endl;
+        } else {
+            cout << "\nGeen kandidaat haalde de taalcheck; volledige ranking:" << endl;
+            print_ranked(text, state.top.ranked());
+        }
+    } else if (output_mode == OutputMode::Ranked) {
+        print_ranked(text, state.top.ranked());
+    }
+
+    if (!results_prefix.empty()) {
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - search.started).count();
+        bool solved = output_mode == OutputMode::First && search.early.solved;
+        vector<ShardCandidate> ranked = state.top.ranked();
+        // In --mode first staat de kandidaat die de taalcheck haalde vooraan.
+        if (solved) {
+            ranked.erase(remove_if(ranked.begin(), ranked.end(),
+                                   [&](const ShardCandidate& c) { return c.key == search.early.solution_candidate.key; }),
+                         ranked.end());
+            ranked.insert(ranked.begin(), search.early.solution_candidate);
+        }
+        write_results(results_prefix, results_top, text, solved ? "solved" : "finished", ranked,
+                      state.counters["permutations_tested"], resumed_seconds + seconds);
+    }
 
-        } while (next_permutation(p.begin(), p.end()));
-        
-        cout << "Klaar met breedte " << width << "..." << endl;
+    if (sharded && state.complete()) {
+        cout << "Shard " << shard.index << "/" << shard.count << " klaar; resultaten staan in " << out_path
+             << ". Voeg alle shards samen met --merge." << endl;
+    } else if (sharded) {
+        // --mode first stopte vroeg: de overige blokken staan nog open in het shard-bestand.
+        uint64_t done = count(state.done_blocks.begin(), state.done_blocks.end(), true);
+        cout << "Shard " << shard.index << "/" << shard.count << " is onvolledig: " << done << " van "
+             << state.numBlocks() << " blokken afgewerkt (gestopt na de taalcheck). Start opnieuw met dezelfde --shard en"
+             << " --out " << out_path << " in --mode ranked of stream om hem af te werken; tot dan meldt --merge hem als onvolledig." << endl;
     }
 
     return 0;